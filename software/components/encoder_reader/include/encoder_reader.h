@@ -5,27 +5,43 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "driver/gpio.h"
-#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include <stdatomic.h>
+#if CONFIG_ENCODER_READER_BACKEND_PCNT
+#include "driver/pulse_cnt.h"
+#endif
+
+#define ENCODER_READER_REST_STATE 0x3      // A and B levels (A << 1 | B) at a detent, both high with pull-ups
+#define ENCODER_READER_STEPS_PER_DETENT 4  // Quadrature steps in one detent
 
 struct encoder_reader
 {
     uint64_t pin_a;
     uint64_t pin_b;
     uint64_t pin_sw;
-    uint64_t a_debounce_us;
-    uint64_t b_debounce_us;
     uint64_t sw_debounce_us;
     uint64_t sw_longpress_us;
-    uint8_t pin_b_value;
-    uint8_t pin_b_current_value;
+    uint64_t sw_press_lockout_us;
+    uint64_t sw_press_time;
+#if CONFIG_ENCODER_READER_BACKEND_PCNT
+    pcnt_unit_handle_t pcnt_unit;
+    pcnt_channel_handle_t pcnt_channels[2];
+#else
+    uint8_t quadrature_state;      // Last sampled A and B levels, A << 1 | B
+    int8_t quadrature_steps;       // Steps taken since the last detent
+    uint32_t invalid_transitions;  // Transitions where A and B changed at once, caused by bounce or missed edges
+#endif
+    int32_t position;              // Detents turned since setup, clockwise positive
+    _Atomic int32_t pending_detents; // Detents turned since the handler last took them
+    _Atomic bool batch_queued;     // A rotation tick is in the queue, later detents are added to its batch
+    _Atomic uint32_t queue_overflows; // Ticks dropped because the queue was full
     QueueHandle_t tick_queue;
-    esp_timer_handle_t pin_a_timer;
-    esp_timer_handle_t pin_b_timer;
     esp_timer_handle_t pin_sw_timer;
     esp_timer_handle_t pin_sw_longpress_timer;
+    bool enabled;                  // Interrupts of the instance are on
     void *arg;
-    // LIST_ENTRY(encoder_reader)
-    // list_entry;
+    LIST_ENTRY(encoder_reader)
+    list_entry;
 };
 
 /**
@@ -45,7 +61,8 @@ typedef void (*encoder_reader_cb_t)(void *arg);
 typedef struct
 {
     uint64_t time;
-    int8_t direction;
+    int8_t direction; // 1 or -1 for rotation, take the batch with encoder_reader_take_detents, 0 for select,
+                      // 10 for long press, 20 for switch press edge
 } encoder_tick_t;
 
 /**
@@ -56,10 +73,9 @@ typedef struct
     uint64_t pin_a;
     uint64_t pin_b;
     uint64_t pin_sw;
-    uint64_t a_debounce_us;
-    uint64_t b_debounce_us;
     uint64_t sw_debounce_us;
     uint64_t sw_longpress_us;
+    uint64_t sw_press_lockout_us; //!< Minimum time between reported switch press edges
     QueueHandle_t tick_queue; //!< Function to call when tick to either direction happens
 } encoreder_reader_settings_t;
 
@@ -75,8 +91,8 @@ typedef struct
  *
  * @return
  *      - ESP_OK on success
- *      - ESP_ERR_INVALID_ARG if some of the create_args are not valid
- *      - ESP_ERR_INVALID_STATE if encoder_reader library is not initialized yet
+ *      - ESP_ERR_INVALID_ARG if some of the create_args are not valid or the pins are not distinct
+ *      - ESP_ERR_INVALID_STATE if another instance uses one of the pins
  *      - ESP_ERR_NO_MEM if memory allocation fails
  */
 esp_err_t encoder_reader_setup(const encoreder_reader_settings_t *args,
@@ -95,6 +111,8 @@ esp_err_t encoder_reader_setup(const encoreder_reader_settings_t *args,
  *      - ESP_ERR_INVALID_ARG if some of the create_args are not valid
  *      - ESP_ERR_INVALID_STATE if encoder_reader library is not initialized yet
  *      - ESP_ERR_NO_MEM if memory allocation fails
+ *      - Other errors of the backend, esp_timer_create, gpio_install_isr_service or encoder_reader_enable,
+ *        the created resources are released again and the instance can be deleted or started again
  */
 esp_err_t encoder_reader_start(encoder_reader_handle_t encoder_handle);
 
@@ -106,9 +124,11 @@ esp_err_t encoder_reader_start(encoder_reader_handle_t encoder_handle);
  * @param[out] encoder_handle  Output, pointer to encoder_reader_handle_t variable which
  *                         will hold the created timer handle.
  *
- * @return void
+ * @return
+ *      - ESP_OK on success or if the instance is enabled already
+ *      - Errors of the backend or the switch pin setup, the instance stays disabled
  */
-void encoder_reader_enable(encoder_reader_handle_t encoder_handle);
+esp_err_t encoder_reader_enable(encoder_reader_handle_t encoder_handle);
 
 /**
  * @brief Disable an encoder reader instance
@@ -118,6 +138,48 @@ void encoder_reader_enable(encoder_reader_handle_t encoder_handle);
  * @param[out] encoder_handle  Output, pointer to encoder_reader_handle_t variable which
  *                         will hold the created timer handle.
  *
+ * @return
+ *      - ESP_OK on success or if the instance is disabled already
+ *      - Errors of the backend or of removing the switch pin handler, the instance counts as disabled
+ */
+esp_err_t encoder_reader_disable(encoder_reader_handle_t encoder_handle);
+
+/**
+ * @brief Delete an encoder reader instance
+ *
+ * @note Disables the instance and releases its timers and backend, the other instances keep running
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
  * @return void
  */
-void encoder_reader_disable(encoder_reader_handle_t encoder_handle);
\ No newline at end of file
+void encoder_reader_delete(encoder_reader_handle_t encoder_handle);
+
+/**
+ * @brief Return the detents turned since setup, clockwise positive
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return int32_t position in detents
+ */
+int32_t encoder_reader_get_position(encoder_reader_handle_t encoder_handle);
+
+/**
+ * @brief Take the detents turned since the last call. Rotation is reported in batches, a rotation tick is
+ *        queued for the first detent and the following ones are added to it until they are taken.
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return int32_t detents, clockwise positive, 0 if another call already took them
+ */
+int32_t encoder_reader_take_detents(encoder_reader_handle_t encoder_handle);
+
+/**
+ * @brief Get the number of ticks dropped because the tick queue was full. Dropped rotation is not lost,
+ *        it stays pending for the next rotation tick.
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return uint32_t dropped ticks since setup
+ */
+uint32_t encoder_reader_get_queue_overflows(encoder_reader_handle_t encoder_handle);
\ No newline at end of file
@@ -1,130 +1,133 @@
-#include "../include/encoder_reader.h"
+#include "encoder_reader_backend.h"
 
-SemaphoreHandle_t semaphore;
-static void IRAM_ATTR pin_a_isr_handler(void *arg)
+// Readers created with encoder_reader_setup, only used from tasks to check that the pins are free
+static LIST_HEAD(encoder_reader_list, encoder_reader) encoder_readers = LIST_HEAD_INITIALIZER(encoder_readers);
+static portMUX_TYPE encoder_readers_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Count a tick dropped because the queue was full, from any context
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return void
+ */
+static inline void IRAM_ATTR count_overflow(encoder_reader_handle_t encoder_handle)
 {
-    encoder_reader_handle_t encoder_handle = (encoder_reader_handle_t)arg;
-    if (xSemaphoreTakeFromISR(semaphore, NULL) == pdTRUE)
+    atomic_fetch_add(&encoder_handle->queue_overflows, 1);
+}
+
+/**
+ * @brief Check if a reader uses any of the pins
+ *
+ * @param encoder_handle  Encoder reader instance.
+ * @param pins            Mask of pins.
+ *
+ * @return bool true if a pin is in use
+ */
+static bool uses_pins(encoder_reader_handle_t encoder_handle, uint64_t pins)
+{
+    uint64_t used = 1ULL << encoder_handle->pin_a | 1ULL << encoder_handle->pin_b | 1ULL << encoder_handle->pin_sw;
+    return (used & pins) != 0;
+}
+
+void IRAM_ATTR encoder_reader_report_detents(encoder_reader_handle_t encoder_handle, int8_t detents)
+{
+    encoder_handle->position += detents;
+    atomic_fetch_add(&encoder_handle->pending_detents, detents);
+
+    // One queue item per batch, the handler takes everything turned until it gets to it
+    if (!atomic_exchange(&encoder_handle->batch_queued, true))
     {
-        if (!esp_timer_is_active(encoder_handle->pin_a_timer))
-        {
-            ESP_ERROR_CHECK(esp_timer_start_once(encoder_handle->pin_a_timer, encoder_handle->a_debounce_us));
-        }
-        else
+        encoder_tick_t encoder_tick = {
+            .direction = (detents > 0) ? 1 : -1,
+            .time = esp_timer_get_time()};
+        if (xQueueSendFromISR(encoder_handle->tick_queue, &encoder_tick, NULL) != pdTRUE)
         {
-            ESP_ERROR_CHECK(esp_timer_restart(encoder_handle->pin_a_timer, encoder_handle->a_debounce_us));
+            count_overflow(encoder_handle);
+            atomic_store(&encoder_handle->batch_queued, false);
         }
-        xSemaphoreGiveFromISR(semaphore, NULL); // Release the semaphore
     }
 }
 
-static void IRAM_ATTR pin_b_isr_handler(void *arg)
+/**
+ * @brief Start a one shot timer or restart it if it is running
+ *
+ * @note The timer can fire between the calls, restart then finds it stopped and it is started instead
+ *
+ * @param timer       Timer to start.
+ * @param timeout_us  Timeout in microseconds.
+ *
+ * @return void
+ */
+static void IRAM_ATTR arm_timer(esp_timer_handle_t timer, uint64_t timeout_us)
 {
-    encoder_reader_handle_t encoder_handle = (encoder_reader_handle_t)arg;
-    if (xSemaphoreTakeFromISR(semaphore, NULL) == pdTRUE)
+    if (esp_timer_restart(timer, timeout_us) == ESP_ERR_INVALID_STATE)
     {
-        encoder_handle->pin_b_current_value = gpio_get_level(encoder_handle->pin_b);
-        if (!esp_timer_is_active(encoder_handle->pin_b_timer))
-        {
-            ESP_ERROR_CHECK(esp_timer_start_once(encoder_handle->pin_b_timer, encoder_handle->b_debounce_us));
-        }
-        else
-        {
-            ESP_ERROR_CHECK(esp_timer_restart(encoder_handle->pin_b_timer, encoder_handle->b_debounce_us));
-        }
-        xSemaphoreGiveFromISR(semaphore, NULL); // Release the semaphore
+        esp_timer_start_once(timer, timeout_us);
     }
 }
 
 static void IRAM_ATTR pin_sw_isr_handler(void *arg)
 {
+    // Only this instance is touched, the timer calls are safe from the interrupt and from the timer task
     encoder_reader_handle_t encoder_handle = (encoder_reader_handle_t)arg;
-    if (xSemaphoreTakeFromISR(semaphore, NULL) == pdTRUE)
+    bool neg_edge = gpio_get_level(encoder_handle->pin_sw) ? false : true;
+    if (neg_edge)
     {
-        bool neg_edge = gpio_get_level(encoder_handle->pin_sw) ? false : true;
-        if (neg_edge)
-        {
-            // Handle long press timer
-            if (!esp_timer_is_active(encoder_handle->pin_sw_longpress_timer))
-            {
-                ESP_ERROR_CHECK(esp_timer_start_once(encoder_handle->pin_sw_longpress_timer, encoder_handle->sw_longpress_us));
-            }
-            else
-            {
-                ESP_ERROR_CHECK(esp_timer_restart(encoder_handle->pin_sw_longpress_timer, encoder_handle->sw_longpress_us));
-            }
-        }
-        else
+        // Report the press with the edge time, bounces within the lockout are ignored
+        uint64_t now = esp_timer_get_time();
+        if (now - encoder_handle->sw_press_time >= encoder_handle->sw_press_lockout_us)
         {
-            // Stop long press timer            
-            if (esp_timer_is_active(encoder_handle->pin_sw_longpress_timer))
-            {
-                ESP_ERROR_CHECK(esp_timer_stop(encoder_handle->pin_sw_longpress_timer));
-            }
-            // Handle debounce timer
-            if (!esp_timer_is_active(encoder_handle->pin_sw_timer))
-            {
-                ESP_ERROR_CHECK(esp_timer_start_once(encoder_handle->pin_sw_timer, encoder_handle->sw_debounce_us));
-            }
-            else
+            encoder_handle->sw_press_time = now;
+            encoder_tick_t encoder_tick = {
+                .direction = 20,
+                .time = now};
+            if (xQueueSendFromISR(encoder_handle->tick_queue, &encoder_tick, NULL) != pdTRUE)
             {
-                ESP_ERROR_CHECK(esp_timer_restart(encoder_handle->pin_sw_timer, encoder_handle->sw_debounce_us));
+                count_overflow(encoder_handle);
             }
         }
-        xSemaphoreGiveFromISR(semaphore, NULL); // Release the semaphore
-    }
-}
 
-static void pin_a_debounce_cb(void *arg)
-{
-    encoder_reader_handle_t encoder_handle = (encoder_reader_handle_t)arg;
-    if (xSemaphoreTakeFromISR(semaphore, NULL) == pdTRUE)
+        // Handle long press timer
+        arm_timer(encoder_handle->pin_sw_longpress_timer, encoder_handle->sw_longpress_us);
+    }
+    else
     {
-        if (gpio_get_level(encoder_handle->pin_a) == 0)
-        {
-            encoder_tick_t encoder_tick = {
-                .direction = (encoder_handle->pin_b_value == 1) ? 1 : -1,
-                .time = esp_timer_get_time()};
-            xQueueSendFromISR(encoder_handle->tick_queue, &encoder_tick, NULL);
-        }
-        xSemaphoreGiveFromISR(semaphore, NULL); // Release the semaphore
+        // Stop long press timer, it is not running if it fired already
+        esp_timer_stop(encoder_handle->pin_sw_longpress_timer);
+
+        // Handle debounce timer
+        arm_timer(encoder_handle->pin_sw_timer, encoder_handle->sw_debounce_us);
     }
 }
 
-static void pin_b_debounce_cb(void *arg)
+/**
+ * @brief Queue a switch tick from the timer task
+ *
+ * @param encoder_handle  Encoder reader instance.
+ * @param direction       Tick type, 0 for select or 10 for long press.
+ *
+ * @return void
+ */
+static void send_sw_tick(encoder_reader_handle_t encoder_handle, int8_t direction)
 {
-    encoder_reader_handle_t encoder_handle = (encoder_reader_handle_t)arg;
-    if (xSemaphoreTakeFromISR(semaphore, NULL) == pdTRUE)
+    encoder_tick_t encoder_tick = {
+        .direction = direction,
+        .time = esp_timer_get_time()};
+    if (xQueueSend(encoder_handle->tick_queue, &encoder_tick, 0) != pdTRUE)
     {
-        encoder_handle->pin_b_value = encoder_handle->pin_b_current_value;
-        xSemaphoreGiveFromISR(semaphore, NULL); // Release the semaphore
+        count_overflow(encoder_handle);
     }
 }
 
 static void pin_sw_debounce_cb(void *arg)
 {
-    encoder_reader_handle_t encoder_handle = (encoder_reader_handle_t)arg;
-    if (xSemaphoreTakeFromISR(semaphore, NULL) == pdTRUE)
-    {
-        encoder_tick_t encoder_tick = {
-            .direction = 0,
-            .time = esp_timer_get_time()};
-        xQueueSendFromISR(encoder_handle->tick_queue, &encoder_tick, NULL);
-        xSemaphoreGiveFromISR(semaphore, NULL); // Release the semaphore
-    }
+    send_sw_tick((encoder_reader_handle_t)arg, 0);
 }
 
 static void pin_sw_longpress_cb(void *arg)
 {
-    encoder_reader_handle_t encoder_handle = (encoder_reader_handle_t)arg;
-    if (xSemaphoreTakeFromISR(semaphore, NULL) == pdTRUE)
-    {
-        encoder_tick_t encoder_tick = {
-            .direction = 10,
-            .time = esp_timer_get_time()};
-        xQueueSendFromISR(encoder_handle->tick_queue, &encoder_tick, NULL);
-        xSemaphoreGiveFromISR(semaphore, NULL); // Release the semaphore
-    }
+    send_sw_tick((encoder_reader_handle_t)arg, 10);
 }
 
 esp_err_t encoder_reader_setup(const encoreder_reader_settings_t *args,
@@ -132,12 +135,19 @@ esp_err_t encoder_reader_setup(const encoreder_reader_settings_t *args,
 {
     // Check input arguments
     if (args == NULL || out_handle == NULL || args->pin_a == 0 ||
-        args->pin_b == 0 || args->pin_sw == 0 || args->a_debounce_us == 0 ||
-        args->b_debounce_us == 0 || args->sw_debounce_us == 0 || args->sw_longpress_us == 0 || args->tick_queue == NULL)
+        args->pin_b == 0 || args->pin_sw == 0 ||
+        args->sw_debounce_us == 0 || args->sw_longpress_us == 0 || args->tick_queue == NULL)
     {
         return ESP_ERR_INVALID_ARG;
     }
 
+    // Every instance needs pins of its own
+    if (args->pin_a == args->pin_b || args->pin_a == args->pin_sw || args->pin_b == args->pin_sw)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint64_t pins = 1ULL << args->pin_a | 1ULL << args->pin_b | 1ULL << args->pin_sw;
+
     // Allocate memory
     encoder_reader_handle_t result = (encoder_reader_handle_t)heap_caps_calloc(1, sizeof(*result), MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
     if (result == NULL)
@@ -149,79 +159,179 @@ esp_err_t encoder_reader_setup(const encoreder_reader_settings_t *args,
     result->pin_a = args->pin_a;
     result->pin_b = args->pin_b;
     result->pin_sw = args->pin_sw;
-    result->a_debounce_us = args->a_debounce_us;
-    result->b_debounce_us = args->b_debounce_us;
     result->sw_debounce_us = args->sw_debounce_us;
     result->sw_longpress_us = args->sw_longpress_us;
+    result->sw_press_lockout_us = args->sw_press_lockout_us;
     result->tick_queue = args->tick_queue;
-    *out_handle = result;
 
-    // Create the semaphore
-    semaphore = xSemaphoreCreateBinary();
-    if (semaphore == NULL)
+    // Register the instance unless another one has the pins
+    bool pins_free = true;
+    encoder_reader_handle_t other;
+    portENTER_CRITICAL(&encoder_readers_lock);
+    LIST_FOREACH(other, &encoder_readers, list_entry)
     {
-        // Handle semaphore creation failure
-        return ESP_ERR_NO_MEM;
+        pins_free = pins_free && !uses_pins(other, pins);
+    }
+    if (pins_free)
+    {
+        LIST_INSERT_HEAD(&encoder_readers, result, list_entry);
+    }
+    portEXIT_CRITICAL(&encoder_readers_lock);
+    if (!pins_free)
+    {
+        heap_caps_free(result);
+        return ESP_ERR_INVALID_STATE;
     }
 
-    // Initialize the semaphore to available state
-    xSemaphoreGive(semaphore);
-
+    *out_handle = result;
     return ESP_OK;
 }
 
+/**
+ * @brief Release the resources created by encoder_reader_start
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return void
+ */
+static void release_resources(encoder_reader_handle_t encoder_handle)
+{
+    if (encoder_handle->pin_sw_timer != NULL)
+    {
+        esp_timer_stop(encoder_handle->pin_sw_timer);
+        esp_timer_delete(encoder_handle->pin_sw_timer);
+        encoder_handle->pin_sw_timer = NULL;
+    }
+    if (encoder_handle->pin_sw_longpress_timer != NULL)
+    {
+        esp_timer_stop(encoder_handle->pin_sw_longpress_timer);
+        esp_timer_delete(encoder_handle->pin_sw_longpress_timer);
+        encoder_handle->pin_sw_longpress_timer = NULL;
+    }
+    encoder_reader_backend_delete(encoder_handle);
+}
+
 esp_err_t encoder_reader_start(encoder_reader_handle_t encoder_handle)
 {
-    // Create timers for debouncing the switches
-    const esp_timer_create_args_t pin_a_debounce_timer_args = {
-        .callback = &pin_a_debounce_cb,
-        .arg = encoder_handle,
-        .name = "pin_a_debounce_timer"};
-    ESP_ERROR_CHECK(esp_timer_create(&pin_a_debounce_timer_args, &encoder_handle->pin_a_timer));
-    const esp_timer_create_args_t pin_b_debounce_timer_args = {
-        .callback = &pin_b_debounce_cb,
-        .arg = encoder_handle,
-        .name = "pin_b_debounce_timer"};
-    ESP_ERROR_CHECK(esp_timer_create(&pin_b_debounce_timer_args, &encoder_handle->pin_b_timer));
+    // Create the rotation decoding resources
+    esp_err_t ret = encoder_reader_backend_start(encoder_handle);
+    if (ret != ESP_OK)
+    {
+        release_resources(encoder_handle);
+        return ret;
+    }
+
+    // Create timer for debouncing the switch, the rotation is decoded without timers
     const esp_timer_create_args_t pin_sw_debounce_timer_args = {
         .callback = &pin_sw_debounce_cb,
         .arg = encoder_handle,
         .name = "pin_sw_debounce_timer"};
-    ESP_ERROR_CHECK(esp_timer_create(&pin_sw_debounce_timer_args, &encoder_handle->pin_sw_timer));
+    ret = esp_timer_create(&pin_sw_debounce_timer_args, &encoder_handle->pin_sw_timer);
+    if (ret != ESP_OK)
+    {
+        release_resources(encoder_handle);
+        return ret;
+    }
 
     // Create timer for switch long press
     const esp_timer_create_args_t pin_sw_longpress_timer_args = {
         .callback = &pin_sw_longpress_cb,
         .arg = encoder_handle,
         .name = "pin_sw_longpress_timer"};
-    ESP_ERROR_CHECK(esp_timer_create(&pin_sw_longpress_timer_args, &encoder_handle->pin_sw_longpress_timer));
+    ret = esp_timer_create(&pin_sw_longpress_timer_args, &encoder_handle->pin_sw_longpress_timer);
+    if (ret != ESP_OK)
+    {
+        release_resources(encoder_handle);
+        return ret;
+    }
 
-    // Enable ISR service and interrupts for pins
-    encoder_reader_enable(encoder_handle);
-    return ESP_OK;
+    // The ISR service is shared by all instances and never uninstalled, the first start installs it
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+    {
+        release_resources(encoder_handle);
+        return ret;
+    }
+
+    // Enable interrupts for pins
+    ret = encoder_reader_enable(encoder_handle);
+    if (ret != ESP_OK)
+    {
+        release_resources(encoder_handle);
+    }
+    return ret;
 }
 
-void encoder_reader_enable(encoder_reader_handle_t encoder_handle)
-{    
-    gpio_install_isr_service(0);
-    // Configure the GPIO pins as input, with pullup
+esp_err_t encoder_reader_enable(encoder_reader_handle_t encoder_handle)
+{
+    if (encoder_handle->enabled)
+    {
+        return ESP_OK;
+    }
+    esp_err_t ret = encoder_reader_backend_enable(encoder_handle);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    // Configure the switch pin as input
     gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << encoder_handle->pin_a | 1ULL << encoder_handle->pin_b | 1ULL << encoder_handle->pin_sw),
+        .pin_bit_mask = (1ULL << encoder_handle->pin_sw),
         .mode = GPIO_MODE_INPUT,
         .intr_type = GPIO_INTR_ANYEDGE, // Trigger on rising and falling edges
         .pull_up_en = GPIO_PULLUP_DISABLE,
     };
-    gpio_config(&io_conf);
-    gpio_set_intr_type(encoder_handle->pin_a, GPIO_INTR_NEGEDGE);
-    gpio_isr_handler_add(encoder_handle->pin_a, pin_a_isr_handler, (void *)encoder_handle);
-    gpio_isr_handler_add(encoder_handle->pin_b, pin_b_isr_handler, (void *)encoder_handle);
-    gpio_isr_handler_add(encoder_handle->pin_sw, pin_sw_isr_handler, (void *)encoder_handle);
+    ret = gpio_config(&io_conf);
+    if (ret == ESP_OK)
+    {
+        ret = gpio_isr_handler_add(encoder_handle->pin_sw, pin_sw_isr_handler, (void *)encoder_handle);
+    }
+    if (ret != ESP_OK)
+    {
+        encoder_reader_backend_disable(encoder_handle);
+        return ret;
+    }
+    encoder_handle->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t encoder_reader_disable(encoder_reader_handle_t encoder_handle)
+{
+    if (!encoder_handle->enabled)
+    {
+        return ESP_OK;
+    }
+    encoder_handle->enabled = false;
+    esp_err_t ret = encoder_reader_backend_disable(encoder_handle);
+    esp_err_t ret_sw = gpio_isr_handler_remove(encoder_handle->pin_sw);
+    return (ret != ESP_OK) ? ret : ret_sw;
+}
+
+void encoder_reader_delete(encoder_reader_handle_t encoder_handle)
+{
+    // Stop the interrupts before the resources they use are released
+    encoder_reader_disable(encoder_handle);
+    release_resources(encoder_handle);
+
+    portENTER_CRITICAL(&encoder_readers_lock);
+    LIST_REMOVE(encoder_handle, list_entry);
+    portEXIT_CRITICAL(&encoder_readers_lock);
+    heap_caps_free(encoder_handle);
+}
+
+int32_t encoder_reader_get_position(encoder_reader_handle_t encoder_handle)
+{
+    return encoder_handle->position;
+}
+
+int32_t encoder_reader_take_detents(encoder_reader_handle_t encoder_handle)
+{
+    // Clear the flag first, detents reported after it go to a new tick
+    atomic_store(&encoder_handle->batch_queued, false);
+    return atomic_exchange(&encoder_handle->pending_detents, 0);
 }
 
-void encoder_reader_disable(encoder_reader_handle_t encoder_handle)
+uint32_t encoder_reader_get_queue_overflows(encoder_reader_handle_t encoder_handle)
 {
-    gpio_isr_handler_remove(encoder_handle->pin_a);
-    gpio_isr_handler_remove(encoder_handle->pin_b);
-    gpio_isr_handler_remove(encoder_handle->pin_sw);
-    gpio_uninstall_isr_service();
+    return atomic_load(&encoder_handle->queue_overflows);
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef ENCODER_READER_BACKEND_H
+#define ENCODER_READER_BACKEND_H
+
+#include "../include/encoder_reader.h"
+
+// Rotation decoding backends, one of encoder_reader_gpio.c and encoder_reader_pcnt.c is built
+// depending on CONFIG_ENCODER_READER_BACKEND
+
+/**
+ * @brief Create the resources of the backend, called once from encoder_reader_start. Resources created before
+ * an error are released again.
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return esp_err_t error from the drivers
+ */
+esp_err_t encoder_reader_backend_start(encoder_reader_handle_t encoder_handle);
+
+/**
+ * @brief Start decoding the rotation, the GPIO ISR service is installed. Nothing is left enabled on error.
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return esp_err_t error from the drivers
+ */
+esp_err_t encoder_reader_backend_enable(encoder_reader_handle_t encoder_handle);
+
+/**
+ * @brief Stop decoding the rotation
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return esp_err_t error from the drivers
+ */
+esp_err_t encoder_reader_backend_disable(encoder_reader_handle_t encoder_handle);
+
+/**
+ * @brief Release the resources of the backend, the instance is disabled
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return void
+ */
+void encoder_reader_backend_delete(encoder_reader_handle_t encoder_handle);
+
+/**
+ * @brief Report turned detents from the backend ISR, queues a rotation tick unless one is already queued
+ *
+ * @param encoder_handle  Encoder reader instance.
+ * @param detents         Detents turned, clockwise positive.
+ *
+ * @return void
+ */
+void encoder_reader_report_detents(encoder_reader_handle_t encoder_handle, int8_t detents);
+
+#endif // ENCODER_READER_BACKEND_H
\ No newline at end of file
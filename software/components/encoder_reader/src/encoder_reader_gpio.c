@@ -0,0 +1,92 @@
+#include "encoder_reader_backend.h"
+
+// Quadrature steps indexed by the previous and the current A and B levels, (previous << 2) | current.
+// 1 and -1 are steps along the Gray code, 0 is no change or an invalid jump where both pins changed.
+// A bounce steps back and forth and cancels out, so the table rejects bounce without debounce timers.
+static const int8_t quadrature_table[16] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+
+static void IRAM_ATTR pin_ab_isr_handler(void *arg)
+{
+    encoder_reader_handle_t encoder_handle = (encoder_reader_handle_t)arg;
+
+    // Sample both pins at once, the edge that triggered the interrupt does not matter
+    uint8_t state = (gpio_get_level(encoder_handle->pin_a) << 1) | gpio_get_level(encoder_handle->pin_b);
+    uint8_t previous = encoder_handle->quadrature_state;
+    encoder_handle->quadrature_state = state;
+    int8_t step = quadrature_table[(previous << 2) | state];
+    if (step == 0)
+    {
+        if ((previous ^ state) == 0x3)
+        {
+            encoder_handle->invalid_transitions++;
+        }
+        return;
+    }
+    encoder_handle->quadrature_steps += step;
+
+    // A detent is a full cycle back to the rest state, anything less was bounce or a half turn
+    if (state == ENCODER_READER_REST_STATE)
+    {
+        int8_t direction = 0;
+        if (encoder_handle->quadrature_steps >= ENCODER_READER_STEPS_PER_DETENT)
+        {
+            direction = 1;
+        }
+        else if (encoder_handle->quadrature_steps <= -ENCODER_READER_STEPS_PER_DETENT)
+        {
+            direction = -1;
+        }
+        encoder_handle->quadrature_steps = 0;
+        if (direction != 0)
+        {
+            encoder_reader_report_detents(encoder_handle, direction);
+        }
+    }
+}
+
+esp_err_t encoder_reader_backend_start(encoder_reader_handle_t encoder_handle)
+{
+    return ESP_OK;
+}
+
+esp_err_t encoder_reader_backend_enable(encoder_reader_handle_t encoder_handle)
+{
+    // Configure the GPIO pins as input
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << encoder_handle->pin_a | 1ULL << encoder_handle->pin_b),
+        .mode = GPIO_MODE_INPUT,
+        .intr_type = GPIO_INTR_ANYEDGE, // Trigger on rising and falling edges
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+    };
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    // Start decoding from the current levels, both pins share one handler
+    encoder_handle->quadrature_state = (gpio_get_level(encoder_handle->pin_a) << 1) | gpio_get_level(encoder_handle->pin_b);
+    encoder_handle->quadrature_steps = 0;
+    ret = gpio_isr_handler_add(encoder_handle->pin_a, pin_ab_isr_handler, (void *)encoder_handle);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    ret = gpio_isr_handler_add(encoder_handle->pin_b, pin_ab_isr_handler, (void *)encoder_handle);
+    if (ret != ESP_OK)
+    {
+        gpio_isr_handler_remove(encoder_handle->pin_a);
+    }
+    return ret;
+}
+
+esp_err_t encoder_reader_backend_disable(encoder_reader_handle_t encoder_handle)
+{
+    esp_err_t ret = gpio_isr_handler_remove(encoder_handle->pin_a);
+    esp_err_t ret_b = gpio_isr_handler_remove(encoder_handle->pin_b);
+    return (ret != ESP_OK) ? ret : ret_b;
+}
+
+void encoder_reader_backend_delete(encoder_reader_handle_t encoder_handle)
+{
+}
\ No newline at end of file
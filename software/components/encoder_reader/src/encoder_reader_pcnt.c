@@ -0,0 +1,147 @@
+#include "encoder_reader_backend.h"
+
+/**
+ * @brief Watch point callback, the counter is cleared at both limits so every event is one detent
+ *
+ * @param unit       Pulse counter unit.
+ * @param edata      Watch point that was reached.
+ * @param user_ctx   Encoder reader instance.
+ *
+ * @return bool false, no task is woken directly
+ */
+static bool IRAM_ATTR pcnt_reach_cb(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+{
+    encoder_reader_report_detents((encoder_reader_handle_t)user_ctx, (edata->watch_point_value > 0) ? 1 : -1);
+    return false;
+}
+
+/**
+ * @brief Configure the created unit: glitch filter, both channels, watch points and the callback
+ *
+ * @param encoder_handle  Encoder reader instance.
+ *
+ * @return esp_err_t error from the first driver call that failed
+ */
+static esp_err_t configure_unit(encoder_reader_handle_t encoder_handle)
+{
+    // Pulses shorter than the filter are contact noise, longer bounce steps back and forth and cancels out
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = CONFIG_ENCODER_READER_PCNT_GLITCH_NS,
+    };
+    esp_err_t ret = pcnt_unit_set_glitch_filter(encoder_handle->pcnt_unit, &filter_config);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    // Count every edge of both pins, the level of the other pin gives the direction. Clockwise is positive,
+    // matching the transition table of the GPIO backend.
+    const pcnt_chan_config_t chan_configs[2] = {
+        {.edge_gpio_num = encoder_handle->pin_a, .level_gpio_num = encoder_handle->pin_b},
+        {.edge_gpio_num = encoder_handle->pin_b, .level_gpio_num = encoder_handle->pin_a},
+    };
+    const pcnt_channel_edge_action_t rising_actions[2] = {PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE};
+    const pcnt_channel_edge_action_t falling_actions[2] = {PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE};
+    for (int i = 0; i < 2; i++)
+    {
+        ret = pcnt_new_channel(encoder_handle->pcnt_unit, &chan_configs[i], &encoder_handle->pcnt_channels[i]);
+        if (ret == ESP_OK)
+        {
+            ret = pcnt_channel_set_edge_action(encoder_handle->pcnt_channels[i], rising_actions[i], falling_actions[i]);
+        }
+        if (ret == ESP_OK)
+        {
+            ret = pcnt_channel_set_level_action(encoder_handle->pcnt_channels[i], PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+        }
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+    }
+
+    // Interrupt only at the limits, one per detent instead of one per edge
+    ret = pcnt_unit_add_watch_point(encoder_handle->pcnt_unit, ENCODER_READER_STEPS_PER_DETENT);
+    if (ret == ESP_OK)
+    {
+        ret = pcnt_unit_add_watch_point(encoder_handle->pcnt_unit, -ENCODER_READER_STEPS_PER_DETENT);
+    }
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    pcnt_event_callbacks_t callbacks = {
+        .on_reach = pcnt_reach_cb,
+    };
+    return pcnt_unit_register_event_callbacks(encoder_handle->pcnt_unit, &callbacks, encoder_handle);
+}
+
+esp_err_t encoder_reader_backend_start(encoder_reader_handle_t encoder_handle)
+{
+    // One detent in both directions, the hardware clears the count when it reaches a limit
+    pcnt_unit_config_t unit_config = {
+        .high_limit = ENCODER_READER_STEPS_PER_DETENT,
+        .low_limit = -ENCODER_READER_STEPS_PER_DETENT,
+    };
+    esp_err_t ret = pcnt_new_unit(&unit_config, &encoder_handle->pcnt_unit);
+    if (ret != ESP_OK)
+    {
+        // No unit is free, e.g. all are taken by other instances
+        return ret;
+    }
+
+    // Release the unit and the channels created so far if any setting is refused
+    ret = configure_unit(encoder_handle);
+    if (ret != ESP_OK)
+    {
+        encoder_reader_backend_delete(encoder_handle);
+    }
+    return ret;
+}
+
+esp_err_t encoder_reader_backend_enable(encoder_reader_handle_t encoder_handle)
+{
+    // Start counting from the detent the encoder rests at
+    esp_err_t ret = pcnt_unit_enable(encoder_handle->pcnt_unit);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    ret = pcnt_unit_clear_count(encoder_handle->pcnt_unit);
+    if (ret == ESP_OK)
+    {
+        ret = pcnt_unit_start(encoder_handle->pcnt_unit);
+    }
+    if (ret != ESP_OK)
+    {
+        pcnt_unit_disable(encoder_handle->pcnt_unit);
+    }
+    return ret;
+}
+
+esp_err_t encoder_reader_backend_disable(encoder_reader_handle_t encoder_handle)
+{
+    esp_err_t ret = pcnt_unit_stop(encoder_handle->pcnt_unit);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return pcnt_unit_disable(encoder_handle->pcnt_unit);
+}
+
+void encoder_reader_backend_delete(encoder_reader_handle_t encoder_handle)
+{
+    if (encoder_handle->pcnt_unit == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (encoder_handle->pcnt_channels[i] != NULL)
+        {
+            pcnt_del_channel(encoder_handle->pcnt_channels[i]);
+            encoder_handle->pcnt_channels[i] = NULL;
+        }
+    }
+    pcnt_del_unit(encoder_handle->pcnt_unit);
+    encoder_handle->pcnt_unit = NULL;
+}
\ No newline at end of file
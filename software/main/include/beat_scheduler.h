@@ -0,0 +1,110 @@
+#ifndef BEAT_SCHEDULER_H
+#define BEAT_SCHEDULER_H
+
+#include <stdint.h>
+
+#define US_PER_MINUTE 60000000ULL // microseconds in a minute
+#define SWING_STRAIGHT 50         // swing percent of straight timing
+#define SWING_MAX 75              // largest swing percent, triplet feel at 67
+
+/**
+ * @brief Beat scheduler state. The beat period is kept as an exact fraction of
+ * microseconds (period_num / period_den) and the division remainder is carried
+ * from beat to beat, so the timestamp of beat N never drifts. Subdivisions are placed
+ * between the beats with the swing applied, so the beats themselves are never moved.
+ */
+typedef struct
+{
+    uint64_t origin_time;    // Timestamp of the origin beat
+    uint64_t origin_beat;    // Index of the origin beat
+    uint64_t period_num;     // Beat period numerator, period = period_num / period_den us
+    uint32_t period_den;     // Beat period denominator
+    uint64_t period_us;      // Whole microseconds of the beat period
+    uint32_t remainder_step; // Fractional part of the beat period in 1/period_den us
+    uint32_t remainder;      // Accumulated fractional part in 1/period_den us
+    uint64_t beat;           // Index of the next beat
+    uint64_t time;           // Timestamp of the next beat
+    uint8_t swing;           // Position of the off-beat half as percent of the beat
+} beat_scheduler_t;
+
+/**
+ * Initialize the scheduler so that beat 0 happens at start_time
+ *
+ * @param beat_scheduler_t* scheduler Scheduler to initialize.
+ * @param uint64_t start_time Timestamp of the first beat in microseconds.
+ * @param uint16_t bpm Tempo in beats per minute.
+ * @return void.
+ */
+void beat_scheduler_init(beat_scheduler_t *scheduler, uint64_t start_time, uint16_t bpm);
+
+/**
+ * Make the given beat the new origin of the timeline and continue from it with the given period
+ *
+ * @param beat_scheduler_t* scheduler Scheduler to modify.
+ * @param uint64_t beat Index of the new origin beat, becomes the next beat.
+ * @param uint64_t time Timestamp of the new origin beat.
+ * @param uint64_t period_num Beat period numerator.
+ * @param uint32_t period_den Beat period denominator.
+ * @return void.
+ */
+void beat_scheduler_rephase(beat_scheduler_t *scheduler, uint64_t beat, uint64_t time, uint64_t period_num, uint32_t period_den);
+
+/**
+ * Change the tempo starting from the next beat, the next beat keeps its timestamp
+ *
+ * @param beat_scheduler_t* scheduler Scheduler to modify.
+ * @param uint16_t bpm New tempo in beats per minute.
+ * @return void.
+ */
+void beat_scheduler_set_bpm(beat_scheduler_t *scheduler, uint16_t bpm);
+
+/**
+ * Set the swing. The off-beat half of every beat is delayed to the given percent of the beat and the
+ * subdivisions on both sides are stretched or compressed to fit, 50 is straight timing.
+ *
+ * @param beat_scheduler_t* scheduler Scheduler to modify.
+ * @param uint8_t swing Swing percent, from SWING_STRAIGHT to SWING_MAX.
+ * @return void.
+ */
+void beat_scheduler_set_swing(beat_scheduler_t *scheduler, uint8_t swing);
+
+/**
+ * Return the timestamp of a subdivision of the beat interval ending at the next beat, with the swing applied.
+ * Integer math only, safe to call from ISR.
+ *
+ * @param const beat_scheduler_t* scheduler Scheduler to query.
+ * @param uint64_t last_beat_time Timestamp of the beat starting the interval.
+ * @param uint32_t tick Position of the subdivision in the beat, 0 to ticks_per_beat.
+ * @param uint32_t ticks_per_beat Subdivision ticks in one beat.
+ * @return uint64_t timestamp of the subdivision in microseconds.
+ */
+uint64_t beat_scheduler_subdivision_time(const beat_scheduler_t *scheduler, uint64_t last_beat_time, uint32_t tick, uint32_t ticks_per_beat);
+
+/**
+ * Move to the following beat. Uses only additions, safe to call from ISR.
+ *
+ * @param beat_scheduler_t* scheduler Scheduler to advance.
+ * @return uint64_t timestamp of the new next beat.
+ */
+uint64_t beat_scheduler_advance(beat_scheduler_t *scheduler);
+
+/**
+ * Move to the following beat after the given interval and make it the new origin, the period is kept.
+ * Used when the interval comes from elsewhere, e.g. a tempo curve. Safe to call from ISR.
+ *
+ * @param beat_scheduler_t* scheduler Scheduler to advance.
+ * @param uint32_t interval_us Interval to the following beat in microseconds.
+ * @return uint64_t timestamp of the new next beat.
+ */
+uint64_t beat_scheduler_advance_interval(beat_scheduler_t *scheduler, uint32_t interval_us);
+
+/**
+ * Return the absolute timestamp of beat N on the current timeline
+ *
+ * @param const beat_scheduler_t* scheduler Scheduler to query.
+ * @param uint64_t beat Index of the beat, must not be before the origin beat.
+ * @return uint64_t timestamp of the beat in microseconds.
+ */
+uint64_t beat_scheduler_beat_time(const beat_scheduler_t *scheduler, uint64_t beat);
+
+#endif // BEAT_SCHEDULER_H
\ No newline at end of file
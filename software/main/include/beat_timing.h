@@ -0,0 +1,69 @@
+#ifndef BEAT_TIMING_H
+#define BEAT_TIMING_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#define BEAT_TIMING_RING_SIZE 128    // Beats kept for the statistics, power of two
+#define BEAT_TIMING_NOT_SET UINT32_MAX // Latency of a stage that did not happen
+
+/**
+ * @brief Measured stages of the beat output path, latencies are relative to the scheduled alarm
+ */
+typedef enum
+{
+    BEAT_TIMING_ISR_ENTRY, // Alarm ISR entered
+    BEAT_TIMING_EDGE,      // Output edge set
+    BEAT_TIMING_DEQUEUE,   // Beat received by the output task
+    BEAT_TIMING_STAGES,
+} beat_timing_stage_t;
+
+/**
+ * @brief Latency statistics of one stage over the beats in the ring buffer, in microseconds
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t max;
+} beat_timing_stats_t;
+
+/**
+ * Record the ISR side timestamps of a beat. Lock free, safe to call from ISR.
+ *
+ * @param uint64_t alarm_time Scheduled alarm timestamp.
+ * @param uint64_t isr_time Timestamp at ISR entry.
+ * @param uint64_t edge_time Timestamp after the output edge, 0 if no edge was set.
+ * @return uint32_t sequence number of the beat, used to record the dequeue time.
+ */
+uint32_t beat_timing_record_isr(uint64_t alarm_time, uint64_t isr_time, uint64_t edge_time);
+
+/**
+ * Record the time the output task dequeued the beat
+ *
+ * @param uint32_t sequence Sequence number returned by beat_timing_record_isr.
+ * @param uint64_t dequeue_time Timestamp when the task received the beat.
+ * @return void.
+ */
+void beat_timing_record_dequeue(uint32_t sequence, uint64_t dequeue_time);
+
+/**
+ * Calculate latency statistics of one stage over the recorded beats
+ *
+ * @param beat_timing_stage_t stage Stage to calculate the statistics for.
+ * @param beat_timing_stats_t* stats Statistics to fill.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for unknown stage, ESP_ERR_NOT_FOUND if there are no samples.
+ */
+esp_err_t beat_timing_get_stats(beat_timing_stage_t stage, beat_timing_stats_t *stats);
+
+/**
+ * Log the statistics of all stages
+ *
+ * @param void.
+ * @return void.
+ */
+void beat_timing_log_dump(void);
+
+#endif // BEAT_TIMING_H
\ No newline at end of file
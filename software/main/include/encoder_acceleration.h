@@ -0,0 +1,72 @@
+#ifndef ENCODER_ACCELERATION_H
+#define ENCODER_ACCELERATION_H
+
+#include <stdint.h>
+
+#define ENCODER_ACCELERATION_RATE_BITS 4         // Fractional bits of the smoothed rate
+#define ENCODER_ACCELERATION_GAIN_ONE 256        // Gain of one bpm per detent
+#define ENCODER_ACCELERATION_MIN_INTERVAL_US 2000 // Shorter intervals are rounded up, limits the rate to 500 detents per second
+
+/**
+ * @brief Point of an acceleration curve, the gain is interpolated linearly between the points
+ */
+typedef struct
+{
+    uint16_t rate; // Detents per second
+    uint16_t gain; // Bpm per detent in 1/ENCODER_ACCELERATION_GAIN_ONE
+} encoder_acceleration_point_t;
+
+/**
+ * @brief Acceleration curve, points in ascending rate order
+ */
+typedef struct
+{
+    const encoder_acceleration_point_t *points;
+    uint8_t count;
+    uint8_t smoothing_shift; // The smoothed rate moves 1/2^shift of the way to each measured rate
+    uint32_t expire_us;      // Pause after which turning starts again from the slowest rate
+} encoder_acceleration_curve_t;
+
+/**
+ * @brief Encoder acceleration state. The step size follows an exponentially smoothed rate of the detents
+ * and the fractions of a bpm are carried over, so the step grows continuously with the speed.
+ */
+typedef struct
+{
+    uint32_t rate;       // Smoothed detents per second with ENCODER_ACCELERATION_RATE_BITS fractional bits
+    uint64_t last_time;  // Time of the first detent of the last step, 0 before the first
+    uint32_t last_count; // Detents of the last step, turned between last_time and the next step
+    int8_t direction;    // Direction of the last detents
+    int16_t remainder;   // Fraction of a bpm carried to the next step, in 1/ENCODER_ACCELERATION_GAIN_ONE
+} encoder_acceleration_t;
+
+/**
+ * Reset the state, the next detent moves at the slowest rate
+ *
+ * @param encoder_acceleration_t* acceleration State to reset.
+ * @return void.
+ */
+void encoder_acceleration_init(encoder_acceleration_t *acceleration);
+
+/**
+ * Return the gain of a rate from the curve, the end points are held outside the curve
+ *
+ * @param const encoder_acceleration_curve_t* curve Curve to read.
+ * @param uint32_t rate Detents per second with ENCODER_ACCELERATION_RATE_BITS fractional bits.
+ * @return uint32_t bpm per detent in 1/ENCODER_ACCELERATION_GAIN_ONE.
+ */
+uint32_t encoder_acceleration_gain(const encoder_acceleration_curve_t *curve, uint32_t rate);
+
+/**
+ * Update the smoothed rate with turned detents and return the bpm change
+ *
+ * @param encoder_acceleration_t* acceleration State to update.
+ * @param const encoder_acceleration_curve_t* curve Curve giving the step size.
+ * @param int32_t detents Detents turned, clockwise positive.
+ * @param uint64_t time Time of the first of the detents in microseconds.
+ * @return int32_t bpm change, with the sign of the detents.
+ */
+int32_t encoder_acceleration_step(encoder_acceleration_t *acceleration, const encoder_acceleration_curve_t *curve,
+                                  int32_t detents, uint64_t time);
+
+#endif // ENCODER_ACCELERATION_H
\ No newline at end of file
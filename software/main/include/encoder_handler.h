@@ -14,6 +14,16 @@ typedef struct
     int8_t direction;
 } action_t;
 
+// Encoder handler counters
+typedef struct
+{
+    uint32_t wakeups;   // Times the task woke to a tick
+    uint32_t ticks;     // Ticks taken from the queue
+    uint32_t detents;   // Detents taken from the encoder reader
+    uint32_t publishes; // Bpm changes published to the shared state
+    uint32_t overflows; // Ticks the encoder reader dropped with a full queue
+} encoder_stats_t;
+
 /**
  *
  * Enter sleep mode handler
@@ -25,7 +35,18 @@ void handle_sleep_mode(encoder_reader_handle_t encoder);
 
 /**
  *
- * Handle select button click
+ * Handle switch long press. Holding until ENC_SW_SLEEP_HOLD enters sleep mode, an earlier release toggles
+ * the tap mode where presses are taps
+ *
+ * @param encoder_reader_handle_t encoder object handle
+ * @param encoder_tick_t* tick
+ * @return void.
+ */
+void handle_long_press(encoder_reader_handle_t encoder, encoder_tick_t *tick);
+
+/**
+ *
+ * Handle select button click, ignored in the tap mode
  *
  * @param int8_t previous direction
  * @param encoder_tick_t* tick
@@ -35,14 +56,31 @@ void handle_select(int8_t prev_direction, encoder_tick_t *tick);
 
 /**
  *
- * Handle up/down action
+ * Handle switch press edge, feed it to the tap tempo estimator in the tap mode
  *
- * @param int8_t previous direction
  * @param encoder_tick_t* tick
- * @param action_t* initiated action.
  * @return void.
  */
-int8_t handle_up_down(int8_t prev_direction, encoder_tick_t *tick, action_t *action);
+void handle_tap(encoder_tick_t *tick);
+
+/**
+ *
+ * Handle up/down action, the step size follows the turning speed
+ *
+ * @param encoder_tick_t* tick
+ * @param int32_t detents turned, clockwise positive
+ * @return int32_t bpm change.
+ */
+int32_t handle_up_down(encoder_tick_t *tick, int32_t detents);
+
+/**
+ *
+ * Copy the encoder handler counters
+ *
+ * @param encoder_stats_t* stats Counters to fill.
+ * @return void.
+ */
+void encoder_handler_get_stats(encoder_stats_t *stats);
 
 /**
  *
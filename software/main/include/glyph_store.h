@@ -0,0 +1,50 @@
+#ifndef GLYPH_STORE_H
+#define GLYPH_STORE_H
+
+#include "resources.h"
+#include <stdint.h>
+
+#define GLYPH_PAGES 4                                 // 8 pixel rows per page
+#define GLYPH_COLUMNS 32
+#define GLYPH_IMAGE_SIZE (GLYPH_PAGES * GLYPH_COLUMNS) // Bytes per decoded image, page after page
+#define GLYPH_CACHE_SLOTS 5                           // Glyphs on the screen at once and the one replacing them
+
+// Glyph ids, in the order of the bitmaps in resources.c
+#define GLYPH_SIGNATURE(index) (index)
+#define GLYPH_NUMBER(index) (SIGNATURE_IMAGES + (index))
+#define GLYPH_STANDBY(index) (SIGNATURE_IMAGES + NUMBER_IMAGES + (index))
+#define GLYPH_COUNT (SIGNATURE_IMAGES + NUMBER_IMAGES + STANDBY_IMAGES)
+
+/**
+ * @brief Glyph cache counters
+ */
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+} glyph_store_stats_t;
+
+// Run length encoded page ordered images in flash, generated at build time from the bitmaps in resources.c.
+// A control byte c < 0x80 is followed by c + 1 literal bytes, c >= 0x80 repeats the next byte c - 0x80 + 2 times.
+// Image n is encoded in glyph_store_data[glyph_store_index[n]] to glyph_store_data[glyph_store_index[n + 1]].
+extern const uint16_t glyph_store_index[GLYPH_COUNT + 1];
+extern const uint8_t glyph_store_data[];
+
+/**
+ * Return the decoded image of a glyph. Recently used glyphs are kept decoded in a small LRU cache, the
+ * least recently used one is decoded over on a miss. Not thread safe, used by the screen task only.
+ *
+ * @param uint8_t glyph Glyph id, see GLYPH_SIGNATURE, GLYPH_NUMBER and GLYPH_STANDBY.
+ * @return const uint8_t* GLYPH_IMAGE_SIZE bytes, valid until GLYPH_CACHE_SLOTS other glyphs have been requested.
+ */
+const uint8_t *glyph_store_get(uint8_t glyph);
+
+/**
+ * Read the glyph cache counters
+ *
+ * @param glyph_store_stats_t* stats Counters to fill.
+ * @return void.
+ */
+void glyph_store_get_stats(glyph_store_stats_t *stats);
+
+#endif // GLYPH_STORE_H
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef METER_PATTERNS_H
+#define METER_PATTERNS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define METER_MAX_BEATS 16  // Beats in the longest bar, limited by the packed accent word
+#define METER_ACCENT_BITS 2 // Bits per beat in the packed accent word
+#define METER_PATTERN_COUNT 7
+
+/**
+ * @brief Accent level of a beat
+ */
+typedef enum
+{
+    METER_ACCENT_MUTE,
+    METER_ACCENT_WEAK,
+    METER_ACCENT_MEDIUM,
+    METER_ACCENT_STRONG,
+} meter_accent_t;
+
+/**
+ * @brief Bit packed bar. Beat n (counted from 0) has its accent level in bits 2n..2n+1
+ * of accents and its group start flag in bit n of groups, e.g. 7/8 as 2+2+3 starts groups on beats 0, 2 and 4.
+ */
+typedef struct
+{
+    uint32_t accents; // Packed accent levels
+    uint16_t groups;  // Beats starting a group
+    uint8_t length;   // Beats in the bar
+    uint8_t glyph;    // Index of the signature image
+} meter_pattern_t;
+
+/**
+ * Return the pattern with the given index. The patterns are const data in flash.
+ *
+ * @param uint16_t index Pattern index, wraps around the pattern count.
+ * @return const meter_pattern_t* pattern.
+ */
+const meter_pattern_t *get_meter_pattern(uint16_t index);
+
+/**
+ * Return the accent level of a beat
+ *
+ * @param const meter_pattern_t* pattern Bar pattern.
+ * @param uint8_t beat Beat in the bar, starting from 1.
+ * @return meter_accent_t accent level.
+ */
+static inline meter_accent_t meter_pattern_accent(const meter_pattern_t *pattern, uint8_t beat)
+{
+    return (meter_accent_t)((pattern->accents >> ((beat - 1) * METER_ACCENT_BITS)) & METER_ACCENT_STRONG);
+}
+
+/**
+ * Check if a beat starts a group
+ *
+ * @param const meter_pattern_t* pattern Bar pattern.
+ * @param uint8_t beat Beat in the bar, starting from 1.
+ * @return bool true if the beat starts a group.
+ */
+static inline bool meter_pattern_group_start(const meter_pattern_t *pattern, uint8_t beat)
+{
+    return (pattern->groups >> (beat - 1)) & 1;
+}
+
+#endif // METER_PATTERNS_H
\ No newline at end of file
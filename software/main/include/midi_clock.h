@@ -0,0 +1,53 @@
+#ifndef MIDI_CLOCK_H
+#define MIDI_CLOCK_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MIDI_CLOCK_PPQN 24        // Timing clock pulses per quarter note
+#define MIDI_CLOCK_PER_POSITION 6 // Timing clock pulses per song position step (16th note)
+#define MIDI_BAUD_RATE 31250
+
+// MIDI system real time and common messages
+#define MIDI_TIMING_CLOCK 0xF8
+#define MIDI_START 0xFA
+#define MIDI_CONTINUE 0xFB
+#define MIDI_STOP 0xFC
+#define MIDI_SONG_POSITION 0xF2
+
+/**
+ * Configure the MIDI UART. Messages are written straight to the hardware TX FIFO,
+ * so no UART driver, task or ring buffer is involved.
+ *
+ * @param void
+ * @return esp_err_t error from the UART configuration.
+ */
+esp_err_t midi_clock_init(void);
+
+/**
+ * Write a message to the TX FIFO without blocking. Safe to call from ISR.
+ *
+ * @param const uint8_t* bytes Message bytes.
+ * @param uint8_t length Number of bytes.
+ * @return bool false if the FIFO did not have room and the message was dropped.
+ */
+bool midi_clock_send(const uint8_t *bytes, uint8_t length);
+
+/**
+ * Write a Song Position Pointer message. Safe to call from ISR.
+ *
+ * @param uint16_t position Position in 16th notes from the start of the song, 14 bits.
+ * @return bool false if the FIFO did not have room and the message was dropped.
+ */
+bool midi_clock_send_song_position(uint16_t position);
+
+/**
+ * Return the number of messages dropped because the TX FIFO was full
+ *
+ * @param void
+ * @return uint32_t dropped messages.
+ */
+uint32_t midi_clock_get_dropped(void);
+
+#endif // MIDI_CLOCK_H
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef MIDI_PLL_H
+#define MIDI_PLL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MIDI_PLL_FRACTION_BITS 16      // Fractional bits of the fixed point phase and period
+#define MIDI_PLL_ACQUIRE_KP_SHIFT 1    // Phase gain 1/2 while acquiring
+#define MIDI_PLL_ACQUIRE_KI_SHIFT 4    // Frequency gain 1/16 while acquiring
+#define MIDI_PLL_LOCKED_KP_SHIFT 4     // Phase gain 1/16 when locked
+#define MIDI_PLL_LOCKED_KI_SHIFT 8     // Frequency gain 1/256 when locked
+#define MIDI_PLL_LOCK_PERCENT 10       // Average phase error limit for lock as percent of the period
+#define MIDI_PLL_ERROR_AVERAGE_SHIFT 3 // Phase error averaged over about 8 pulses
+#define MIDI_PLL_LOCK_PULSES 24        // Pulses within the limit needed for lock
+#define MIDI_PLL_MIN_PERIOD_US 2000    // Shortest pulse period followed, about 1250 bpm
+#define MIDI_PLL_MAX_PERIOD_US 250000  // Longest pulse period followed, 10 bpm
+
+/**
+ * @brief State of the MIDI clock PLL
+ */
+typedef enum
+{
+    MIDI_PLL_IDLE,      // No clock received
+    MIDI_PLL_MEASURING, // One pulse received, waiting for the first period
+    MIDI_PLL_TRACKING,  // Following the clock
+} midi_pll_state_t;
+
+/**
+ * @brief Second order software PLL following a 24 PPQN MIDI clock. A phase detector compares each
+ * pulse with the predicted one and a proportional-integral loop filter corrects the phase and the period.
+ * Phase and period are fixed point microseconds.
+ */
+typedef struct
+{
+    midi_pll_state_t state;
+    uint64_t phase;         // Filtered time of the last pulse
+    uint64_t period;        // Filtered pulse period
+    uint32_t pulse;         // Pulses since Start, pulse 0 is the first beat
+    uint64_t error_average; // Moving average of the phase error magnitude
+    uint16_t lock_count;    // Consecutive pulses within the lock limit
+    bool locked;
+} midi_pll_t;
+
+/**
+ * Initialize the PLL to wait for a clock
+ *
+ * @param midi_pll_t* pll PLL to initialize.
+ * @return void.
+ */
+void midi_pll_init(midi_pll_t *pll);
+
+/**
+ * Restart the pulse count on MIDI Start, the next pulse is on the first beat
+ *
+ * @param midi_pll_t* pll PLL to modify.
+ * @return void.
+ */
+void midi_pll_start(midi_pll_t *pll);
+
+/**
+ * Feed a received timing clock
+ *
+ * @param midi_pll_t* pll PLL to update.
+ * @param uint64_t time Receive time in microseconds.
+ * @return void.
+ */
+void midi_pll_input(midi_pll_t *pll, uint64_t time);
+
+/**
+ * Return the filtered time of the next beat after the last pulse
+ *
+ * @param const midi_pll_t* pll Tracking PLL.
+ * @return uint64_t time of the next beat in microseconds.
+ */
+uint64_t midi_pll_next_beat_time(const midi_pll_t *pll);
+
+/**
+ * Return the filtered beat period as a fraction
+ *
+ * @param const midi_pll_t* pll Tracking PLL.
+ * @param uint64_t* period_num Numerator of the beat period in microseconds.
+ * @param uint32_t* period_den Denominator of the beat period.
+ * @return void.
+ */
+void midi_pll_beat_period(const midi_pll_t *pll, uint64_t *period_num, uint32_t *period_den);
+
+#endif // MIDI_PLL_H
\ No newline at end of file
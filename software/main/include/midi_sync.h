@@ -0,0 +1,28 @@
+#ifndef MIDI_SYNC_H
+#define MIDI_SYNC_H
+
+#include "esp_err.h"
+
+#define MIDI_SYNC_RX_BUFFER 256     // UART driver RX buffer in bytes, must exceed the hardware FIFO
+#define MIDI_SYNC_QUEUE_LENGTH 16
+#define MIDI_SYNC_EDGE_RING_SIZE 64 // Stamped falling edges of the RX line waiting for their bytes, power of two
+#define MIDI_SYNC_PULSE 12          // Clock pulse of each beat the timeline is synced on, halfway between the beats
+
+/**
+ * Task following the MIDI clock input. Timing clock pulses are filtered through the PLL and the beat
+ * timeline is moved onto the predicted beats once the PLL has locked. The metronome runs free without a clock.
+ *
+ * @param void* arg UART event queue.
+ * @return void.
+ */
+void midi_sync_task(void *arg);
+
+/**
+ * Setup the MIDI input UART and start the MIDI sync task. Call after the output handler is started.
+ *
+ * @param void
+ * @return esp_err_t error from the UART driver or task creation.
+ */
+esp_err_t start_midi_sync(void);
+
+#endif // MIDI_SYNC_H
\ No newline at end of file
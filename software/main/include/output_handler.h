@@ -1,17 +1,155 @@
 #ifndef OUTPUT_HANDLER_H
 #define OUTPUT_HANDLER_H
 
+#include "esp_err.h"
+#include "tempo_automation.h"
+#include "rhythm_timeline.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief When a tempo change takes effect
+ */
+typedef enum
+{
+    TEMPO_APPLY_NEXT_BEAT,     // Reschedule the pending beat with the new period
+    TEMPO_APPLY_NEXT_DOWNBEAT, // Change the period from the next downbeat onwards
+    TEMPO_APPLY_AT_BEAT,       // Change the period from the given beat index onwards
+} tempo_apply_t;
+
 /**
- * Click the output x times
+ * @brief What to do with a click that starts while the previous pulse is still active. Every click is cut to
+ * OUTPUT_MAX_DUTY_PERCENT of the time until the next event first, the policy only handles the overlap.
+ */
+typedef enum
+{
+    OUTPUT_OVERRUN_SHORTEN,  // Only cut clicks to the duty limit, an overlapping click extends the active pulse
+    OUTPUT_OVERRUN_DROP,     // Skip a click that starts while the previous pulse is still active
+    OUTPUT_OVERRUN_COALESCE, // Extend the active pulse over the new click
+} output_overrun_policy_t;
+
+/**
+ * @brief Overrun counters of the output engine since start
+ */
+typedef struct
+{
+    uint32_t overruns;      // Clicks cut or overlapping, shortened + dropped + coalesced
+    uint32_t shortened;     // Clicks cut to the duty limit
+    uint32_t dropped;       // Clicks skipped
+    uint32_t coalesced;     // Clicks merged into the active pulse
+    uint32_t late_events;   // Events played late because their time had passed when scheduled
+    uint32_t dropped_beats; // Beats the output task could not receive in time
+} output_overrun_counters_t;
+
+/**
+ * Start a click: set the output high now and let the pulse timer set it low. Safe to call from ISR.
  *
- * @param long_click. If the click should have longer period between on & off of the relay
+ * @param duration_us. Time between on & off of the relay in microseconds
  * @param led_on. Bool for turning the led on for the duration or not
  * @return void.
  */
-void click(bool long_click, bool led_on);
+void click(uint32_t duration_us, bool led_on);
+
+/**
+ * Change the output tempo. The timeline is re-phased on the beat the change applies on, so the
+ * following beats are exact multiples of the new period from it.
+ *
+ * @param uint16_t bpm New tempo in beats per minute.
+ * @param tempo_apply_t apply When the change takes effect.
+ * @param uint64_t beat Beat index for TEMPO_APPLY_AT_BEAT, ignored otherwise.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for invalid bpm, ESP_ERR_NO_MEM if too many changes are pending.
+ */
+esp_err_t output_handler_set_tempo(uint16_t bpm, tempo_apply_t apply, uint64_t beat);
+
+/**
+ * Start playing a tempo curve from the next downbeat. Any manual tempo change stops it. The curve is copied
+ * outside the lock to the buffer the timer ISR is not playing, so call it from one task at a time.
+ *
+ * @param const tempo_automation_t* automation Tempo curve to play, copied by the output handler.
+ * @return esp_err_t ESP_ERR_INVALID_ARG if the curve is empty.
+ */
+esp_err_t output_handler_start_automation(const tempo_automation_t *automation);
+
+/**
+ * Stop the tempo curve and keep its current tempo
+ *
+ * @param void.
+ * @return void.
+ */
+void output_handler_stop_automation(void);
+
+/**
+ * Play the given subdivision and polyrhythm voices on top of the main beat, starting from the next beat.
+ * The start voices come from SUBDIVISION and POLYRHYTHM_PULSES, there is no user interface for changing them.
+ *
+ * @param const rhythm_voice_t* voices Voices to play, may be NULL if voice_count is 0.
+ * @param uint8_t voice_count Number of voices.
+ * @return esp_err_t ESP_ERR_INVALID_STATE if the previous change is still pending, rhythm_timeline_build errors otherwise.
+ */
+esp_err_t output_handler_set_rhythm(const rhythm_voice_t *voices, uint8_t voice_count);
+
+/**
+ * Follow an external clock: move the pending beat to beat_time and continue with the given period
+ *
+ * @param uint64_t beat_time Time of the pending beat on the output timer.
+ * @param uint64_t period_num Numerator of the beat period in microseconds.
+ * @param uint32_t period_den Denominator of the beat period.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for a zero period.
+ */
+esp_err_t output_handler_sync(uint64_t beat_time, uint64_t period_num, uint32_t period_den);
+
+/**
+ * Return the current time of the output timer, the timebase of the beat timeline
+ *
+ * @param void
+ * @return uint64_t time in microseconds.
+ */
+uint64_t output_handler_get_time(void);
+
+/**
+ * Set the swing of the subdivisions between the beats. Call after the output handler is started, which applies
+ * SWING_PERCENT through it. There is no user interface for changing the swing at runtime.
+ *
+ * @param uint8_t swing Position of the off-beat half as percent of the beat, 50 (straight) to 75.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for a swing out of range.
+ */
+esp_err_t output_handler_set_swing(uint8_t swing);
+
+/**
+ * Start or stop the MIDI clock. Start is sent on the next downbeat followed by 24 timing clocks per beat,
+ * Stop is sent right away with the song position reached.
+ *
+ * @param bool running True to start, false to stop.
+ * @return void.
+ */
+void output_handler_set_midi_clock(bool running);
+
+/**
+ * Set how clicks that do not fit their period are handled
+ *
+ * @param output_overrun_policy_t policy Overrun policy.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for unknown policy.
+ */
+esp_err_t output_handler_set_overrun_policy(output_overrun_policy_t policy);
+
+/**
+ * Read the overrun counters
+ *
+ * @param output_overrun_counters_t* counters Counters to fill.
+ * @return void.
+ */
+void output_handler_get_overrun_counters(output_overrun_counters_t *counters);
+
+/**
+ * Return the index of the next beat on the output timeline
+ *
+ * @param void.
+ * @return uint64_t index of the next beat.
+ */
+uint64_t output_handler_get_beat_index(void);
 
 /**
- * Output handler, activate output in case the flag is set
+ * Output handler, receive the beats played by the beat ISR and keep the outputs off while the system is off
  *
  * @param arg Arguments passed to the event.
  * @return void.
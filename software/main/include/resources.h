@@ -4,16 +4,15 @@
 
 #include <stdint.h>
 
-#define SIGNATURE_IMAGES 3
+#define SIGNATURE_IMAGES 7
 #define NUMBER_IMAGES 10
 #define STANDBY_IMAGES 4
 
-extern uint16_t signature_modes[SIGNATURE_IMAGES];
+// Row ordered 32 pixel wide bitmaps. resources.c is not compiled into the firmware, it is the source of the
+// compressed glyph store generated at build time by tools/glyph_gen.py, see glyph_store.h
+
 extern uint8_t segment_display_signatures[SIGNATURE_IMAGES][192];
-extern uint8_t segment_display_signatures_inverse[SIGNATURE_IMAGES][192];
 extern uint8_t segment_display_numbers[NUMBER_IMAGES][192];
-extern uint8_t segment_display_numbers_inverse[NUMBER_IMAGES][192];
 extern uint8_t segment_display_standby[STANDBY_IMAGES][192];
-extern uint8_t segment_display_standby_inverse[STANDBY_IMAGES][192];
 
 #endif // RESOURCES_H
\ No newline at end of file
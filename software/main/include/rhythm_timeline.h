@@ -0,0 +1,55 @@
+#ifndef RHYTHM_TIMELINE_H
+#define RHYTHM_TIMELINE_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#define RHYTHM_MAX_VOICES 4        // Voices on top of the main beat
+#define RHYTHM_MAX_EVENTS 96       // Merged events in one cycle
+#define RHYTHM_MAX_CYCLE_BEATS 16  // Beats before the merged pattern repeats
+#define RHYTHM_MAX_TICKS 0xFFFF    // Grid resolution limit per beat
+#define RHYTHM_MAIN_VOICE (1 << 0) // Voice bit of the main beat, voice n uses bit n + 1
+
+/**
+ * @brief Voice that spreads pulses evenly over beats. Subdivisions use one beat, e.g. 8ths {2, 1},
+ * triplets {3, 1} and 16ths {4, 1}. Polyrhythms span more beats, e.g. 3:2 is {3, 2} and 5:4 is {5, 4}.
+ */
+typedef struct
+{
+    uint8_t pulses;
+    uint8_t beats;
+} rhythm_voice_t;
+
+/**
+ * @brief Merged event of all voices sounding at the same grid position
+ */
+typedef struct
+{
+    uint16_t beat;  // Beat within the cycle
+    uint16_t tick;  // Position within the beat in 1 / ticks_per_beat, 0 is on the beat
+    uint8_t voices; // Bit mask of the sounding voices
+} rhythm_event_t;
+
+/**
+ * @brief One cycle of the merged voices, sorted by time. Every beat starts with a main voice event
+ * so a single alarm can walk the timeline event by event.
+ */
+typedef struct
+{
+    rhythm_event_t events[RHYTHM_MAX_EVENTS];
+    uint16_t event_count;
+    uint16_t ticks_per_beat; // LCM grid resolution that places every voice exactly
+    uint16_t cycle_beats;    // LCM of the voice lengths
+} rhythm_timeline_t;
+
+/**
+ * Merge the main beat and the given voices to a sorted timeline
+ *
+ * @param rhythm_timeline_t* timeline Timeline to build.
+ * @param const rhythm_voice_t* voices Voices on top of the main beat, may be NULL if voice_count is 0.
+ * @param uint8_t voice_count Number of voices.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for invalid voices, ESP_ERR_NO_MEM if the timeline does not fit.
+ */
+esp_err_t rhythm_timeline_build(rhythm_timeline_t *timeline, const rhythm_voice_t *voices, uint8_t voice_count);
+
+#endif // RHYTHM_TIMELINE_H
\ No newline at end of file
@@ -1,42 +1,64 @@
 #ifndef SCREEN_HANDLER_H
 #define SCREEN_HANDLER_H
 
+#include "shared_variables.h"
+
+#define SCREEN_PAGES 4 // 128x32 panel
+#define SCREEN_COLUMNS 128
+#define SCREEN_SPAN_MERGE_GAP 4 // unchanged columns sent to avoid splitting a span into two windows
+#define SCREEN_WINDOW_COST 12   // bus bytes to set a window and start its data, on top of the data itself
+#define SCREEN_MAX_SPANS 16     // changed spans sent one by one, a frame with more is sent as one window
+
+/**
+ * @brief Counters of the data sent to the panel. Frames without changes send nothing and are not counted.
+ */
+typedef struct
+{
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t transactions;
+    uint32_t last_frame_bytes;
+    uint32_t last_frame_transactions;
+    uint32_t failed; // Frames the panel did not acknowledge, resent with the next change
+} screen_stats_t;
+
 /**
- * Populate input array with indexes for correct images to show on screen based on bpm and signature mode
+ * Populate input array with the glyph ids to show on screen based on bpm and signature mode
  *
+ * @param const state_snapshot_t* snapshot State to show.
  * @param arr Array to populate.
  * @return void.
  */
-void get_indexes(uint16_t *arr);
+void get_indexes(const state_snapshot_t *snapshot, uint16_t *arr);
 
 /**
- * Based on if bpm is selected decide if screen should blink and calculate frames for blinking effect
+ * Rotate the screen by 180 degrees, done by the panel so drawing costs the same in both orientations.
+ * The encoder has no gesture for it, rotating at runtime is API only.
  *
- * @param void.
- * @return bool, true if screen should be dim
+ * @param bool rotated true to rotate, the start value is INVERT_SCREEN.
+ * @return void.
  */
-bool is_screen_dim();
+void screen_handler_set_rotation(bool rotated);
 
 /**
- * Handle encoder ticks and modify the bpm or signature based on them
+ * Read the counters of the data sent to the panel
  *
- * @param void.
+ * @param screen_stats_t* stats Counters to fill.
  * @return void.
  */
-void screen_update_handler_task(void *arg);
+void screen_handler_get_stats(screen_stats_t *stats);
 
 /**
- * Convert bitmaps to images
+ * Redraw the screen when the shown variables change and blink it while the candidate bpm is not selected.
+ * Sleeps between the changes.
  *
- * @param uint8_t segment_display[][192] segment display array.
- * @param uint8_t *segment_image segment image array.
- * @param size_t image_count
- * @return esp_err_t return fail in case anything fails during conversion.
+ * @param void.
+ * @return void.
  */
-esp_err_t conver_bitmap_to_image(uint8_t segment_display[][192], uint8_t *segment_image, size_t image_count);
+void screen_update_handler_task(void *arg);
 
 /**
- * Setup the screen and the load the images to buffer
+ * Setup the screen and start the screen update task
  *
  * @param void.
  * @return esp_err_t return fail in case anything fails during startup.
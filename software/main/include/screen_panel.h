@@ -0,0 +1,60 @@
+#ifndef SCREEN_PANEL_H
+#define SCREEN_PANEL_H
+
+#include "ssd1306.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCREEN_PANEL_I2C_PORT I2C_NUM_0 // Port set up by i2c_master_init of the ssd1306 component
+#define SCREEN_PANEL_TIMEOUT_MS 100
+
+// SSD1306 commands and control bytes
+#define SSD1306_CONTROL_COMMAND_STREAM 0x00
+#define SSD1306_CONTROL_DATA_STREAM 0x40
+#define SSD1306_SET_MEMORY_ADDRESSING_MODE 0x20
+#define SSD1306_HORIZONTAL_ADDRESSING 0x00
+#define SSD1306_SET_COLUMN_ADDRESS 0x21
+#define SSD1306_SET_PAGE_ADDRESS 0x22
+#define SSD1306_SEGMENT_REMAP_NORMAL 0xA0  // Column 0 on SEG0
+#define SSD1306_SEGMENT_REMAP_REVERSE 0xA1 // Column 127 on SEG0
+#define SSD1306_COM_SCAN_NORMAL 0xC0       // Scan from COM0
+#define SSD1306_COM_SCAN_REVERSE 0xC8      // Scan to COM0
+
+/**
+ * Switch the panel to horizontal addressing and set the orientation. After this the panel must only be drawn
+ * through screen_panel_write_window, the page addressed drawing of the ssd1306 component no longer applies.
+ *
+ * @param SSD1306_t* dev Initialized panel.
+ * @param bool rotated true to rotate the picture by 180 degrees.
+ * @return esp_err_t error from the I2C transaction.
+ */
+esp_err_t screen_panel_init(SSD1306_t *dev, bool rotated);
+
+/**
+ * Rotate the picture by 180 degrees with the segment remap and COM scan direction. The remap only applies
+ * to data written after it, so the whole picture has to be written again.
+ *
+ * @param SSD1306_t* dev Panel.
+ * @param bool rotated true to rotate the picture by 180 degrees.
+ * @return esp_err_t error from the I2C transaction.
+ */
+esp_err_t screen_panel_set_rotation(SSD1306_t *dev, bool rotated);
+
+/**
+ * Write a window of the frame to the panel. The window is set with one command transaction and the
+ * data is streamed in one data transaction, the panel wraps the columns and pages by itself.
+ *
+ * @param SSD1306_t* dev Panel in horizontal addressing.
+ * @param const uint8_t* frame Frame buffer, one row of columns per page.
+ * @param uint8_t columns Columns in one frame buffer row.
+ * @param uint8_t first_page First page of the window.
+ * @param uint8_t last_page Last page of the window, inclusive.
+ * @param uint8_t first_column First column of the window.
+ * @param uint8_t last_column Last column of the window, inclusive.
+ * @return esp_err_t error from the I2C transactions.
+ */
+esp_err_t screen_panel_write_window(SSD1306_t *dev, const uint8_t *frame, uint8_t columns, uint8_t first_page,
+                                    uint8_t last_page, uint8_t first_column, uint8_t last_column);
+
+#endif // SCREEN_PANEL_H
\ No newline at end of file
@@ -13,22 +13,45 @@
 // OUTPUT
 #define OUTPUT_PIN 2
 #define LED_PIN 15
+// MIDI
+#define MIDI_TX_PIN 17
+#define MIDI_RX_PIN 16
+#define MIDI_UART_NUM 1
 
 // ******* OTHER SETTINGS *******
 // OUTPUT
 #define OUTPUT_ACTIVATION_DURATION 50 // milliseconds
+#define OUTPUT_SUBDIVISION_DURATION 20 // milliseconds, click length of voices between the beats
+#define OUTPUT_MAX_DUTY_PERCENT 50    // longest click as percent of the time until the next click
+#define OUTPUT_OVERRUN_POLICY 0       // 0 to only shorten, 1 to drop, 2 to coalesce clicks overlapping the active pulse
+#define SWING_PERCENT 50              // 50 for straight subdivisions, up to 75 to delay the off-beat subdivisions
+#define SUBDIVISION 1                 // clicks per beat, 2 for 8ths, 3 for triplets, 4 for 16ths
+#define POLYRHYTHM_PULSES 0           // pulses of a polyrhythm voice spread over POLYRHYTHM_BEATS, 0 for none
+#define POLYRHYTHM_BEATS 2            // beats spanned by the polyrhythm voice, e.g. 3 pulses over 2 beats
 #define BPM_START 80                  // BPM to start with
 #define SIGNATURE_START 0             // index
-#define INVERT_SCREEN 1               // 0 for non inverted, 1 to invert
+#define INVERT_SCREEN 1               // 0 for non inverted, 1 to rotate by 180 degrees, see screen_handler_set_rotation
+#define SCREEN_BLINK_INTERVAL 210     // milliseconds between blinks while the bpm is not selected
+#define TEMPO_CHANGE_ON_DOWNBEAT 0    // 1 to apply a selected bpm on the next downbeat, 0 on the next beat
+#define BEAT_TIMING_LOG_INTERVAL 500  // beats between beat timing log dumps, 0 to disable
+#define MIDI_CLOCK_ENABLED 0          // 1 to send MIDI clock, started on the first downbeat
+#define MIDI_SYNC_ENABLED 0           // 1 to follow the MIDI clock input when one is received
+#define MIDI_SYNC_TIMEOUT 500         // milliseconds without input before running free again
+#define TEMPO_TRAINER_ENABLED 0       // 1 to raise the tempo from BPM_START in steps after startup
+#define TEMPO_TRAINER_STEP 2          // bpm added by each trainer step
+#define TEMPO_TRAINER_STEP_BEATS 16   // beats played before each trainer step
+#define TEMPO_TRAINER_CEILING 120     // bpm of the last trainer step
 
 // INPUT
-#define FAST_CHANGE_MULTIPLIER 5
-#define DOUBLE_CLICK_US 5E5       // microseconds
-#define FAST_CHANGE_US 1E5        // microseconds
-#define FAST_CHANGE_EXPIRE_US 1E6 // microseconds
-#define ENC_A_DEBOUNCE 1000       // microseconds
-#define ENC_B_DEBOUNCE 1000       // microseconds
-#define ENC_SW_DEBOUNCE 200000    // microseconds
-#define ENC_SW_LONGPRESS 1000000  // microseconds
+#define DOUBLE_CLICK_US 5E5        // microseconds
+// Acceleration curve, detents per second and 1/256 bpm per detent
+#define ENC_ACCEL_CURVE {{0, 256}, {5, 256}, {10, 1536}, {20, 3072}, {35, 5120}}
+#define ENC_ACCEL_SMOOTHING 1      // smoothed rate moves 1/2^n of the way to each measured rate
+#define ENC_ACCEL_EXPIRE_US 300000 // microseconds, pause after which turning starts from one bpm per detent
+#define ENC_SW_DEBOUNCE 200000     // microseconds
+#define ENC_SW_LONGPRESS 1000000   // microseconds, toggles tap tempo when released before ENC_SW_SLEEP_HOLD
+#define ENC_SW_SLEEP_HOLD 3000000  // microseconds the switch is held for sleep mode
+#define ENC_SW_PRESS_LOCKOUT 30000 // microseconds, switch bounces ignored for tap tempo
+#define ENC_STATS_LOG_INTERVAL 100 // encoder handler wakeups between counter logs, 0 to disable
 
 #endif // SETTINGS_H
\ No newline at end of file
@@ -1,8 +1,9 @@
 #ifndef SHARED_VARIABLES_H
 #define SHARED_VARIABLES_H
 
+#include "esp_err.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -15,14 +16,53 @@ typedef enum
     SYSTEM_ON,
 } esp_system_state_t;
 
+// Change notification bits, one per shared variable
+#define STATE_CHANGE_BPM_SELECTED (1 << 0)
+#define STATE_CHANGE_BPM_CANDIDATE (1 << 1)
+#define STATE_CHANGE_SIGNATURE_MODE (1 << 2)
+#define STATE_CHANGE_CURRENT_BEAT (1 << 3)
+#define STATE_CHANGE_SYSTEM_STATE (1 << 4)
+#define STATE_CHANGE_ALL 0x1F
 
 /**
- * Initialize the semaphores
+ * @brief Consistent copy of all shared variables. The variables are published as one
+ * packed atomic word, so readers never block and never see a half updated state.
+ */
+typedef struct
+{
+    uint16_t bpm_selected;
+    uint16_t bpm_candidate;
+    uint16_t signature_mode;
+    uint8_t current_beat;
+    esp_system_state_t system_state;
+} state_snapshot_t;
+
+/**
+ * Initialize the shared variables
  *
  * @param void
- * @return esp_err_t fail if creation of mutexes fails.
+ * @return esp_err_t fail if the state can not be published lock free.
+ */
+esp_err_t init_shared_variables(void);
+
+/**
+ * Notify a task about changes of the shared variables. The changed variables are OR'ed into the task
+ * notification value as STATE_CHANGE_* bits, so the task can block in xTaskNotifyWait until something changes.
+ * There is one subscriber, a new call replaces the previous one.
+ *
+ * @param TaskHandle_t task Task to notify, NULL to stop notifying.
+ * @param uint32_t mask STATE_CHANGE_* bits the task is interested in.
+ * @return void.
  */
-esp_err_t init_semaphores(void);
+void subscribe_state_changes(TaskHandle_t task, uint32_t mask);
+
+/**
+ * Read all shared variables at once. Never blocks, safe to call from ISR.
+ *
+ * @param state_snapshot_t* snapshot Snapshot to fill.
+ * @return void.
+ */
+void get_state_snapshot(state_snapshot_t *snapshot);
 
 /**
  * Return current beat
@@ -38,7 +78,23 @@ uint8_t get_beat(void);
  * @param void
  * @return void.
  */
-void increment_beat();
+void increment_beat(void);
+
+/**
+ * Increment beat from an ISR. The subscriber is notified without yielding, the ISR yields on exit.
+ *
+ * @param BaseType_t* high_task_awoken Set if a higher priority task was woken.
+ * @return void.
+ */
+void increment_beat_from_isr(BaseType_t *high_task_awoken);
+
+/**
+ * Reset beat so the next beat is the downbeat
+ *
+ * @param void
+ * @return void.
+ */
+void reset_beat(void);
 
 /**
  * Change signature mode
@@ -48,6 +104,14 @@ void increment_beat();
  */
 void change_signature_mode(void);
 
+/**
+ * Set signature mode
+ *
+ * @param uint16_t signature_mode Signature mode index.
+ * @return void.
+ */
+void set_signature_mode(uint16_t signature_mode);
+
 /**
  * Return current chosen signature mode
  *
@@ -59,10 +123,10 @@ uint16_t get_signature_mode(void);
 /**
  * Change the bpm candidate by bpm_delta but keep the bpm within limits of 1 and 999
  *
- * @param uint16_t bpm_delta : Change to apply to the candidate bpm
+ * @param int16_t bpm_delta : Change to apply to the candidate bpm
  * @return void.
  */
-void change_bpm(uint16_t bpm_delta);
+void change_bpm(int16_t bpm_delta);
 
 /**
  * Select the candidate bpm as the current selected bpm
@@ -88,6 +152,15 @@ uint16_t get_selected_bpm(void);
  */
 uint16_t get_candidate_bpm(void);
 
+/**
+ * Set the selected bpm to a tempo followed from an external clock. The candidate moves with it unless
+ * it differs from the selected bpm, so a change the user has not selected yet is kept.
+ *
+ * @param uint16_t bpm Followed tempo, limited to 1...999.
+ * @return void.
+ */
+void set_followed_bpm(uint16_t bpm);
+
 /**
  * Reset the candidate bpm to selected bpm
  *
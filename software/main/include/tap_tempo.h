@@ -0,0 +1,65 @@
+#ifndef TAP_TEMPO_H
+#define TAP_TEMPO_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TAP_TEMPO_WINDOW 8              // Intervals in the rolling median
+#define TAP_TEMPO_MIN_INTERVALS 2       // Intervals needed before a tempo is reported
+#define TAP_TEMPO_TIMEOUT_US 2000000    // Pause that starts a new tap sequence
+#define TAP_TEMPO_MIN_INTERVAL_US 60000 // Shortest interval accepted, faster taps are bounces
+#define TAP_TEMPO_OUTLIER_PERCENT 30    // Largest deviation from the median accepted
+#define TAP_TEMPO_MAX_OUTLIERS 2        // Consecutive outliers accepted as a new tempo after this many
+
+/**
+ * @brief Streaming tap tempo estimator. Keeps the last intervals in arrival order for the rolling
+ * window and in sorted order for the median.
+ */
+typedef struct
+{
+    uint32_t intervals[TAP_TEMPO_WINDOW]; // Ring of intervals in arrival order
+    uint32_t sorted[TAP_TEMPO_WINDOW];    // The same intervals in ascending order
+    uint8_t count;                        // Intervals in the window
+    uint8_t head;                         // Oldest interval in the ring
+    uint8_t outliers;                     // Consecutive rejected intervals
+    uint32_t last_outlier;                // Last rejected interval
+    uint64_t last_tap;                    // Time of the last accepted tap, 0 before the first tap
+} tap_tempo_t;
+
+/**
+ * Initialize an empty estimator
+ *
+ * @param tap_tempo_t* tap_tempo Estimator to initialize.
+ * @return void.
+ */
+void tap_tempo_init(tap_tempo_t *tap_tempo);
+
+/**
+ * Check if a tap sequence is running
+ *
+ * @param const tap_tempo_t* tap_tempo Estimator to check.
+ * @param uint64_t now Current time in microseconds.
+ * @return bool true if the last tap is within the timeout.
+ */
+bool tap_tempo_active(const tap_tempo_t *tap_tempo, uint64_t now);
+
+/**
+ * Add a tap. A tap after the timeout starts a new sequence, bounces and outliers are rejected.
+ *
+ * @param tap_tempo_t* tap_tempo Estimator to update.
+ * @param uint64_t time Tap time in microseconds.
+ * @return bool true if the interval to the previous tap was added to the window.
+ */
+bool tap_tempo_tap(tap_tempo_t *tap_tempo, uint64_t time);
+
+/**
+ * Return the tempo of the median interval
+ *
+ * @param const tap_tempo_t* tap_tempo Estimator to read.
+ * @param uint16_t* bpm Estimated tempo, limited to 1...999.
+ * @return esp_err_t ESP_ERR_NOT_FOUND if there are not enough intervals yet.
+ */
+esp_err_t tap_tempo_get_bpm(const tap_tempo_t *tap_tempo, uint16_t *bpm);
+
+#endif // TAP_TEMPO_H
\ No newline at end of file
@@ -0,0 +1,122 @@
+#ifndef TEMPO_AUTOMATION_H
+#define TEMPO_AUTOMATION_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TEMPO_AUTOMATION_MAX_SEGMENTS 24 // Segments in one automation
+#define TEMPO_AUTOMATION_MAX_STEPS 64    // Step intervals of all step segments in one automation
+#define TEMPO_AUTOMATION_RAMP_PIECES 8   // Segments used to follow a linear bpm ramp
+#define TEMPO_AUTOMATION_FRACTION_BITS 32 // Fractional bits of the fixed point intervals
+
+/**
+ * @brief Kind of a tempo curve segment
+ */
+typedef enum
+{
+    TEMPO_SEGMENT_LINEAR, // The beat interval changes by a constant step every beat
+    TEMPO_SEGMENT_STEPS,  // The tempo is held for some beats and then raised by a constant step
+} tempo_segment_type_t;
+
+/**
+ * @brief Part of a tempo curve. Intervals are Q32.32 fixed point microseconds.
+ */
+typedef struct
+{
+    tempo_segment_type_t type;
+    uint32_t beats;        // Beats in the segment, beats of each step in a step segment
+    uint64_t interval;     // Linear: interval after the first beat of the segment
+    int64_t interval_step; // Linear: change of the interval per beat
+    uint16_t first_step;   // Steps: index of the interval of the first step in step_intervals
+    uint16_t steps;        // Steps: number of steps
+} tempo_segment_t;
+
+/**
+ * @brief Precomputed tempo curve and its playback position. Playing a beat only adds
+ * fixed point values, all divisions are done when the segment table is built.
+ */
+typedef struct
+{
+    tempo_segment_t segments[TEMPO_AUTOMATION_MAX_SEGMENTS];
+    uint64_t step_intervals[TEMPO_AUTOMATION_MAX_STEPS]; // Interval of every step of the step segments, Q32.32
+    uint16_t step_count;
+    uint8_t segment_count;
+    uint8_t segment;   // Segment being played
+    uint16_t step;     // Step within the step segment being played
+    uint32_t beat;     // Beat within the segment or step being played
+    uint64_t interval; // Current interval, Q32.32 microseconds
+    uint64_t fraction; // Fractional microseconds carried to the next beat
+    uint16_t last_bpm; // Tempo at the end of the curve
+} tempo_automation_t;
+
+/**
+ * Initialize an empty tempo curve
+ *
+ * @param tempo_automation_t* automation Automation to initialize.
+ * @return void.
+ */
+void tempo_automation_init(tempo_automation_t *automation);
+
+/**
+ * Append a constant tempo to the curve
+ *
+ * @param tempo_automation_t* automation Automation to modify.
+ * @param uint16_t bpm Tempo in beats per minute.
+ * @param uint32_t beats Duration in beats.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for invalid values, ESP_ERR_NO_MEM if the segment table is full.
+ */
+esp_err_t tempo_automation_add_hold(tempo_automation_t *automation, uint16_t bpm, uint32_t beats);
+
+/**
+ * Append a linear tempo ramp to the curve, e.g. accelerando from 80 to 120 bpm over 32 bars
+ *
+ * @param tempo_automation_t* automation Automation to modify.
+ * @param uint16_t bpm_from Tempo at the start of the ramp.
+ * @param uint16_t bpm_to Tempo at the end of the ramp.
+ * @param uint32_t beats Duration in beats.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for invalid values, ESP_ERR_NO_MEM if the segment table is full.
+ */
+esp_err_t tempo_automation_add_ramp(tempo_automation_t *automation, uint16_t bpm_from, uint16_t bpm_to, uint32_t beats);
+
+/**
+ * Append a speed trainer curve, e.g. +2 bpm every 4 bars up to a ceiling. The whole curve is one step segment,
+ * the interval of every step is computed here.
+ *
+ * @param tempo_automation_t* automation Automation to modify.
+ * @param uint16_t bpm_from Starting tempo.
+ * @param uint16_t bpm_step Tempo increase per step.
+ * @param uint32_t beats_per_step Duration of each step in beats.
+ * @param uint16_t bpm_ceiling Last tempo of the curve.
+ * @return esp_err_t ESP_ERR_INVALID_ARG for invalid values, ESP_ERR_NO_MEM if the segment table is full or the
+ * steps do not fit in TEMPO_AUTOMATION_MAX_STEPS.
+ */
+esp_err_t tempo_automation_add_steps(tempo_automation_t *automation, uint16_t bpm_from, uint16_t bpm_step,
+                                     uint32_t beats_per_step, uint16_t bpm_ceiling);
+
+/**
+ * Rewind the curve to its beginning
+ *
+ * @param tempo_automation_t* automation Automation to rewind.
+ * @return void.
+ */
+void tempo_automation_rewind(tempo_automation_t *automation);
+
+/**
+ * Check if the whole curve has been played
+ *
+ * @param const tempo_automation_t* automation Automation to check.
+ * @return bool true when there are no beats left.
+ */
+bool tempo_automation_done(const tempo_automation_t *automation);
+
+/**
+ * Return the interval to the next beat and move forward one beat. O(1) and safe to call from ISR, only loads
+ * and adds the precomputed intervals.
+ *
+ * @param tempo_automation_t* automation Automation to play.
+ * @return uint32_t interval in whole microseconds, the fraction is carried to the next beat.
+ */
+uint32_t tempo_automation_next_interval(tempo_automation_t *automation);
+
+#endif // TEMPO_AUTOMATION_H
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "beat_scheduler.h"
+#include "esp_attr.h"
+
+void beat_scheduler_init(beat_scheduler_t *scheduler, uint64_t start_time, uint16_t bpm)
+{
+    beat_scheduler_rephase(scheduler, 0, start_time, US_PER_MINUTE, bpm);
+    scheduler->swing = SWING_STRAIGHT;
+}
+
+void IRAM_ATTR beat_scheduler_rephase(beat_scheduler_t *scheduler, uint64_t beat, uint64_t time, uint64_t period_num, uint32_t period_den)
+{
+    scheduler->origin_time = time;
+    scheduler->origin_beat = beat;
+    scheduler->period_num = period_num;
+    scheduler->period_den = period_den;
+
+    // Split the period to whole microseconds and the remainder carried between beats
+    scheduler->period_us = period_num / period_den;
+    scheduler->remainder_step = period_num % period_den;
+    scheduler->remainder = 0;
+
+    scheduler->beat = beat;
+    scheduler->time = time;
+}
+
+void IRAM_ATTR beat_scheduler_set_bpm(beat_scheduler_t *scheduler, uint16_t bpm)
+{
+    beat_scheduler_rephase(scheduler, scheduler->beat, scheduler->time, US_PER_MINUTE, bpm);
+}
+
+void beat_scheduler_set_swing(beat_scheduler_t *scheduler, uint8_t swing)
+{
+    scheduler->swing = (swing < SWING_STRAIGHT) ? SWING_STRAIGHT : (swing > SWING_MAX ? SWING_MAX : swing);
+}
+
+uint64_t IRAM_ATTR beat_scheduler_subdivision_time(const beat_scheduler_t *scheduler, uint64_t last_beat_time, uint32_t tick, uint32_t ticks_per_beat)
+{
+    // Position in the beat as a fraction of 100 * ticks_per_beat. The first half maps linearly to [0, swing]
+    // and the second half to [swing, 100], so the off-beat half lands on the swing percent
+    uint64_t position;
+    if (2 * tick <= ticks_per_beat)
+    {
+        position = (uint64_t)2 * tick * scheduler->swing;
+    }
+    else
+    {
+        position = (uint64_t)ticks_per_beat * scheduler->swing + (uint64_t)(2 * tick - ticks_per_beat) * (100 - scheduler->swing);
+    }
+
+    // Computed from the beat timestamps every time so the rounding never accumulates
+    uint64_t period = scheduler->time - last_beat_time;
+    return last_beat_time + period * position / (100ULL * ticks_per_beat);
+}
+
+uint64_t IRAM_ATTR beat_scheduler_advance(beat_scheduler_t *scheduler)
+{
+    // Add the whole microseconds and carry the fractional part forward
+    scheduler->time += scheduler->period_us;
+    scheduler->remainder += scheduler->remainder_step;
+    if (scheduler->remainder >= scheduler->period_den)
+    {
+        scheduler->remainder -= scheduler->period_den;
+        scheduler->time++;
+    }
+    scheduler->beat++;
+    return scheduler->time;
+}
+
+uint64_t IRAM_ATTR beat_scheduler_advance_interval(beat_scheduler_t *scheduler, uint32_t interval_us)
+{
+    // The new beat becomes the origin so the following beats continue from its exact time
+    scheduler->time += interval_us;
+    scheduler->beat++;
+    scheduler->origin_time = scheduler->time;
+    scheduler->origin_beat = scheduler->beat;
+    scheduler->remainder = 0;
+    return scheduler->time;
+}
+
+uint64_t beat_scheduler_beat_time(const beat_scheduler_t *scheduler, uint64_t beat)
+{
+    // floor(n * period_num / period_den) computed in two parts to avoid overflowing 64 bits
+    uint64_t beats_since_origin = beat - scheduler->origin_beat;
+    return scheduler->origin_time + beats_since_origin * scheduler->period_us +
+           beats_since_origin * scheduler->remainder_step / scheduler->period_den;
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "beat_timing.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// Timing of a single beat, latencies in microseconds after the scheduled alarm
+typedef struct
+{
+    _Atomic uint32_t sequence; // Beat sequence + 1 when the record is valid, 0 while it is written
+    uint64_t alarm_time;       // Read by the dequeue only, after claiming the record
+    _Atomic uint32_t latency[BEAT_TIMING_STAGES];
+} beat_timing_record_t;
+
+static beat_timing_record_t records[BEAT_TIMING_RING_SIZE];
+static _Atomic uint32_t next_sequence = 0;
+static const char *stage_names[BEAT_TIMING_STAGES] = {"isr entry", "output edge", "task dequeue"};
+
+/**
+ * Calculate latency from the alarm to the given time, saturated to the latency range
+ *
+ * @param uint64_t time Timestamp of the stage.
+ * @param uint64_t alarm_time Scheduled alarm timestamp.
+ * @return uint32_t latency in microseconds.
+ */
+static inline uint32_t IRAM_ATTR latency_since_alarm(uint64_t time, uint64_t alarm_time)
+{
+    if (time <= alarm_time)
+    {
+        return 0;
+    }
+    uint64_t latency = time - alarm_time;
+    return (latency >= BEAT_TIMING_NOT_SET) ? BEAT_TIMING_NOT_SET - 1 : (uint32_t)latency;
+}
+
+/**
+ * Compare two latencies for qsort
+ *
+ * @param a First latency.
+ * @param b Second latency.
+ * @return int negative, zero or positive.
+ */
+static int compare_latency(const void *a, const void *b)
+{
+    uint32_t latency_a = *(const uint32_t *)a;
+    uint32_t latency_b = *(const uint32_t *)b;
+    return (latency_a > latency_b) - (latency_a < latency_b);
+}
+
+uint32_t IRAM_ATTR beat_timing_record_isr(uint64_t alarm_time, uint64_t isr_time, uint64_t edge_time)
+{
+    uint32_t sequence = atomic_fetch_add(&next_sequence, 1);
+    beat_timing_record_t *record = &records[sequence % BEAT_TIMING_RING_SIZE];
+
+    // Invalidate the record while it is written so readers skip it, the fence keeps the payload after the invalidation
+    atomic_store_explicit(&record->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    record->alarm_time = alarm_time;
+    atomic_store_explicit(&record->latency[BEAT_TIMING_ISR_ENTRY], latency_since_alarm(isr_time, alarm_time), memory_order_relaxed);
+    atomic_store_explicit(&record->latency[BEAT_TIMING_EDGE], edge_time ? latency_since_alarm(edge_time, alarm_time) : BEAT_TIMING_NOT_SET, memory_order_relaxed);
+    atomic_store_explicit(&record->latency[BEAT_TIMING_DEQUEUE], BEAT_TIMING_NOT_SET, memory_order_relaxed);
+    atomic_store_explicit(&record->sequence, sequence + 1, memory_order_release);
+    return sequence;
+}
+
+void beat_timing_record_dequeue(uint32_t sequence, uint64_t dequeue_time)
+{
+    // Only stamp the record if it still belongs to the same beat, and invalidate it while it is written
+    beat_timing_record_t *record = &records[sequence % BEAT_TIMING_RING_SIZE];
+    uint32_t expected = sequence + 1;
+    if (!atomic_compare_exchange_strong_explicit(&record->sequence, &expected, 0, memory_order_acquire, memory_order_relaxed))
+    {
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&record->latency[BEAT_TIMING_DEQUEUE], latency_since_alarm(dequeue_time, record->alarm_time), memory_order_relaxed);
+
+    // The ISR reused the record meanwhile, its beat has not been dequeued yet
+    expected = 0;
+    if (!atomic_compare_exchange_strong_explicit(&record->sequence, &expected, sequence + 1, memory_order_release, memory_order_relaxed))
+    {
+        atomic_store_explicit(&record->latency[BEAT_TIMING_DEQUEUE], BEAT_TIMING_NOT_SET, memory_order_relaxed);
+    }
+}
+
+esp_err_t beat_timing_get_stats(beat_timing_stage_t stage, beat_timing_stats_t *stats)
+{
+    if (stage >= BEAT_TIMING_STAGES || stats == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Collect the samples of consistent records
+    uint32_t samples[BEAT_TIMING_RING_SIZE];
+    uint32_t count = 0;
+    for (int i = 0; i < BEAT_TIMING_RING_SIZE; i++)
+    {
+        // Seqlock read, the fence keeps the payload load before the second sequence load
+        uint32_t sequence = atomic_load_explicit(&records[i].sequence, memory_order_acquire);
+        uint32_t latency = atomic_load_explicit(&records[i].latency[stage], memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (sequence == 0 || atomic_load_explicit(&records[i].sequence, memory_order_relaxed) != sequence || latency == BEAT_TIMING_NOT_SET)
+        {
+            continue;
+        }
+        samples[count++] = latency;
+    }
+    if (count == 0)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Sort the samples to get the percentiles
+    qsort(samples, count, sizeof(uint32_t), compare_latency);
+    stats->count = count;
+    stats->min = samples[0];
+    stats->p50 = samples[(count - 1) * 50 / 100];
+    stats->p99 = samples[(count - 1) * 99 / 100];
+    stats->max = samples[count - 1];
+    return ESP_OK;
+}
+
+void beat_timing_log_dump(void)
+{
+    static const char *TAG = "beat_timing";
+    beat_timing_stats_t stats;
+    for (int stage = 0; stage < BEAT_TIMING_STAGES; stage++)
+    {
+        if (beat_timing_get_stats(stage, &stats) == ESP_OK)
+        {
+            ESP_LOGI(TAG, "%-12s n=%" PRIu32 " min=%" PRIu32 "us p50=%" PRIu32 "us p99=%" PRIu32 "us max=%" PRIu32 "us", stage_names[stage],
+                     stats.count, stats.min, stats.p50, stats.p99, stats.max);
+        }
+        else
+        {
+            ESP_LOGI(TAG, "%-12s no samples", stage_names[stage]);
+        }
+    }
+}
\ No newline at end of file
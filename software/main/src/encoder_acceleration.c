@@ -0,0 +1,65 @@
+#include "encoder_acceleration.h"
+#include <string.h>
+
+#define US_PER_SECOND 1000000ULL
+
+void encoder_acceleration_init(encoder_acceleration_t *acceleration)
+{
+    memset(acceleration, 0, sizeof(*acceleration));
+}
+
+uint32_t encoder_acceleration_gain(const encoder_acceleration_curve_t *curve, uint32_t rate)
+{
+    const encoder_acceleration_point_t *points = curve->points;
+    if (rate <= ((uint32_t)points[0].rate << ENCODER_ACCELERATION_RATE_BITS))
+    {
+        return points[0].gain;
+    }
+    for (uint8_t i = 1; i < curve->count; i++)
+    {
+        uint32_t end = (uint32_t)points[i].rate << ENCODER_ACCELERATION_RATE_BITS;
+        if (rate < end)
+        {
+            uint32_t start = (uint32_t)points[i - 1].rate << ENCODER_ACCELERATION_RATE_BITS;
+            int32_t gain_span = (int32_t)points[i].gain - points[i - 1].gain;
+            return points[i - 1].gain + (int32_t)((int64_t)gain_span * (rate - start) / (end - start));
+        }
+    }
+    return points[curve->count - 1].gain;
+}
+
+int32_t encoder_acceleration_step(encoder_acceleration_t *acceleration, const encoder_acceleration_curve_t *curve,
+                                  int32_t detents, uint64_t time)
+{
+    if (detents == 0)
+    {
+        return 0;
+    }
+    int8_t direction = (detents > 0) ? 1 : -1;
+    uint32_t count = (detents > 0) ? detents : -detents;
+
+    // Turning back or after a pause starts from the slowest rate, without the fractions of the old direction
+    uint64_t interval = time - acceleration->last_time;
+    if (acceleration->last_time == 0 || direction != acceleration->direction || interval > curve->expire_us)
+    {
+        acceleration->rate = 0;
+        acceleration->remainder = 0;
+    }
+    else
+    {
+        // Move the smoothed rate towards the measured rate. The times are those of the first detent of each step,
+        // so the interval since the last step holds the detents of the last step, not the ones of this step.
+        interval = (interval < ENCODER_ACCELERATION_MIN_INTERVAL_US) ? ENCODER_ACCELERATION_MIN_INTERVAL_US : interval;
+        int32_t measured = (((uint64_t)acceleration->last_count << ENCODER_ACCELERATION_RATE_BITS) * US_PER_SECOND) / interval;
+        acceleration->rate += (measured - (int32_t)acceleration->rate) / (1 << curve->smoothing_shift);
+    }
+    acceleration->last_time = time;
+    acceleration->last_count = count;
+    acceleration->direction = direction;
+
+    // Whole bpm are returned and the fraction is carried to the next step
+    int32_t change = (int32_t)(count * encoder_acceleration_gain(curve, acceleration->rate)) * direction + acceleration->remainder;
+    int32_t bpm = change / ENCODER_ACCELERATION_GAIN_ONE;
+    acceleration->remainder = change - bpm * ENCODER_ACCELERATION_GAIN_ONE;
+    return bpm;
+}
\ No newline at end of file
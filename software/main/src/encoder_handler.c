@@ -1,10 +1,45 @@
 #include "encoder_handler.h"
 #include "shared_variables.h"
+#include "output_handler.h"
+#include "tap_tempo.h"
+#include "encoder_acceleration.h"
 #include "esp_sleep.h"
+#include <inttypes.h>
 
 action_t action_select = {0, 0, 0};
-action_t action_up = {0, 0, 1};
-action_t action_down = {0, 0, -1};
+
+static const encoder_acceleration_point_t acceleration_points[] = ENC_ACCEL_CURVE;
+static const encoder_acceleration_curve_t acceleration_curve = {
+    .points = acceleration_points,
+    .count = sizeof(acceleration_points) / sizeof(acceleration_points[0]),
+    .smoothing_shift = ENC_ACCEL_SMOOTHING,
+    .expire_us = ENC_ACCEL_EXPIRE_US,
+};
+static encoder_acceleration_t acceleration;
+
+static encoder_stats_t encoder_stats = {0};
+
+static tap_tempo_t tap_tempo;
+static bool tap_mode = false;     // Switch presses are taps, entered and left with a long press
+static uint64_t tap_mode_time;    // Time the tap mode was entered
+static bool skip_select = false;  // Ignore the select sent when the long press is released
+
+/**
+ * Check if the tap mode is on. It ends by itself once the taps stop for the tap timeout.
+ *
+ * @param uint64_t now Current time in microseconds.
+ * @return bool true while presses are taps.
+ */
+static bool tap_mode_active(uint64_t now)
+{
+    static const char *TAG = "encoder_handler_task";
+    if (tap_mode && !tap_tempo_active(&tap_tempo, now) && now - tap_mode_time >= TAP_TEMPO_TIMEOUT_US)
+    {
+        ESP_LOGI(TAG, "Tap tempo finished");
+        tap_mode = false;
+    }
+    return tap_mode;
+}
 
 void handle_sleep_mode(encoder_reader_handle_t encoder)
 {
@@ -12,8 +47,9 @@ void handle_sleep_mode(encoder_reader_handle_t encoder)
     static const char *TAG = "encoder_handler_task";
     ESP_LOGI(TAG, "Sleep mode requested, handling request");
 
-    // Turn off the screen, LED and output device. Wait for the action to take effect
+    // Turn off the screen, LED, output device and MIDI clock. Wait for the action to take effect
     switch_system_off();
+    output_handler_set_midi_clock(false);
     vTaskDelay(pdMS_TO_TICKS(100));
 
     // Disable existing interrupt
@@ -36,22 +72,68 @@ void handle_sleep_mode(encoder_reader_handle_t encoder)
     ESP_LOGI(TAG, "Exiting sleep mode, enabling interrput back for GPIO%d pin.", ENC_SW_PIN);
     vTaskDelay(pdMS_TO_TICKS(1000));
     switch_system_on();
-    encoder_reader_enable(encoder);
+    if (MIDI_CLOCK_ENABLED)
+    {
+        output_handler_set_midi_clock(true);
+    }
+    esp_err_t ret = encoder_reader_enable(encoder);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not enable the encoder after sleep: %s", esp_err_to_name(ret));
+    }
+}
+
+void handle_long_press(encoder_reader_handle_t encoder, encoder_tick_t *tick)
+{
+    static const char *TAG = "encoder_handler_task";
+
+    // Keep holding for sleep mode, release before it to toggle the tap mode
+    while (gpio_get_level(ENC_SW_PIN) == 0)
+    {
+        if (esp_timer_get_time() - tick->time >= ENC_SW_SLEEP_HOLD - ENC_SW_LONGPRESS)
+        {
+            handle_sleep_mode(encoder);
+            return;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    skip_select = true;
+    if (tap_mode_active(esp_timer_get_time()))
+    {
+        ESP_LOGI(TAG, "Leaving tap tempo");
+        tap_mode = false;
+        return;
+    }
+    ESP_LOGI(TAG, "Tap tempo, press the switch on the beat");
+    tap_tempo_init(&tap_tempo);
+    tap_mode = true;
+    tap_mode_time = esp_timer_get_time();
 }
 
 void handle_select(int8_t prev_direction, encoder_tick_t *tick)
 {
     static const char *TAG = "encoder_handler_task";
 
-    // Nullify up and down button counters
-    action_up.consecutive_ticks = 0;
-    action_down.consecutive_ticks = 0;
+    // The release of a long press and the taps are not selects
+    if (skip_select || tap_mode_active(tick->time))
+    {
+        skip_select = false;
+        return;
+    }
+
+    // The next turn starts from one bpm per detent
+    encoder_acceleration_init(&acceleration);
 
     // In case the selected_bpm differs from the candidate bpm, change bpm to the selected one
     if (get_selected_bpm() != get_candidate_bpm())
     {
         ESP_LOGI(TAG, "Changing the bpm to %d", get_candidate_bpm());
         select_bpm();
+        esp_err_t ret = output_handler_set_tempo(get_selected_bpm(), TEMPO_CHANGE_ON_DOWNBEAT ? TEMPO_APPLY_NEXT_DOWNBEAT : TEMPO_APPLY_NEXT_BEAT, 0);
+        if (ret != ESP_OK)
+        {
+            ESP_LOGW(TAG, "Tempo change failed: %s", esp_err_to_name(ret));
+        }
     }
     // In case the selected bpm is the same as the candidate bpm, change the signature mode
     else
@@ -80,36 +162,55 @@ void handle_select(int8_t prev_direction, encoder_tick_t *tick)
     // }
 }
 
-int8_t handle_up_down(int8_t prev_direction, encoder_tick_t *tick, action_t *action)
+void handle_tap(encoder_tick_t *tick)
 {
-    // Nullify up and select button counters
-    action_select.consecutive_ticks = 0;
-    if (action->direction == 1)
-    {
-        action_down.consecutive_ticks = 0;
-    }
-    else
+    static const char *TAG = "encoder_handler_task";
+
+    // Presses are only taps in the tap mode
+    if (!tap_mode_active(tick->time) || !tap_tempo_tap(&tap_tempo, tick->time))
     {
-        action_up.consecutive_ticks = 0;
+        return;
     }
 
-    // Count towards fast changes if time between last tick is below the set limit and direction is the same
-    // In case direction is different or time since last change is over 1 second, zero the count
-    uint64_t time_since_last_tick = tick->time - action->prev_tick_time;
-    if (time_since_last_tick < FAST_CHANGE_US && tick->direction == prev_direction)
+    // Offer the tapped tempo as the candidate, a select after the tap mode ends applies it
+    uint16_t bpm;
+    if (tap_tempo_get_bpm(&tap_tempo, &bpm) == ESP_OK)
     {
-        action->consecutive_ticks++;
+        ESP_LOGI(TAG, "Tap tempo %d bpm", bpm);
+        change_bpm(bpm - get_candidate_bpm());
     }
-    // In case direction is different or time since last change is over the set limit, zero the count
-    else if (time_since_last_tick > FAST_CHANGE_EXPIRE_US || tick->direction != prev_direction)
+}
+
+int32_t handle_up_down(encoder_tick_t *tick, int32_t detents)
+{
+    // Nullify select button counter
+    action_select.consecutive_ticks = 0;
+
+    // Step size from the smoothed turning speed, the tick time is the ISR time of the first detent
+    return encoder_acceleration_step(&acceleration, &acceleration_curve, detents, tick->time);
+}
+
+/**
+ * Publish the folded bpm change to the shared state with one update
+ *
+ * @param int32_t* bpm_delta Folded change, zeroed after publishing.
+ * @return void.
+ */
+static void publish_bpm_delta(int32_t *bpm_delta)
+{
+    if (*bpm_delta == 0)
     {
-        action->consecutive_ticks = 1;
+        return;
     }
-    // Update select button info
-    action->prev_tick_time = tick->time;
+    int32_t delta = (*bpm_delta > 999) ? 999 : (*bpm_delta < -999 ? -999 : *bpm_delta);
+    change_bpm(delta);
+    encoder_stats.publishes++;
+    *bpm_delta = 0;
+}
 
-    // With 3 or more fast changes, multiply change by the set value
-    return action->consecutive_ticks > 3 ? tick->direction * FAST_CHANGE_MULTIPLIER : tick->direction;
+void encoder_handler_get_stats(encoder_stats_t *stats)
+{
+    *stats = encoder_stats;
 }
 
 void encoder_handler_task(void *arg)
@@ -132,35 +233,71 @@ void encoder_handler_task(void *arg)
     {
         if (xQueueReceive(encoder_tick_queue, &tick, pdMS_TO_TICKS(5000)))
         {
-            // Handle bpm set command
-            if (tick.direction == 0)
-            {
-                handle_select(prev_direction, &tick);
-                prev_direction = tick.direction;
-                continue;
-            }
-            else if (tick.direction == 10)
-            {
-                handle_sleep_mode(encoder);
-            }
-            // Handle down click and get multiplier for changing the bpm value
-            else if (tick.direction == -1)
+            encoder_stats.wakeups++;
+
+            // Drain the queue, consecutive turns in one direction are folded to one bpm change
+            int32_t bpm_delta = 0;
+            do
             {
-                int8_t bpm_delta = handle_up_down(prev_direction, &tick, &action_down);
+                encoder_stats.ticks++;
+
+                // Handle the clicks turned since the last tick and get the accelerated bpm change
+                if (tick.direction == 1 || tick.direction == -1)
+                {
+                    int32_t detents = encoder_reader_take_detents(encoder);
+                    if (detents == 0)
+                    {
+                        continue; // Batch taken with an earlier tick
+                    }
+                    encoder_stats.detents += (detents > 0) ? detents : -detents;
+                    tick.direction = (detents > 0) ? 1 : -1;
+                    if (tick.direction != prev_direction)
+                    {
+                        publish_bpm_delta(&bpm_delta);
+                    }
+                    bpm_delta += handle_up_down(&tick, detents);
+                    prev_direction = tick.direction;
+                    continue;
+                }
+
+                // Other ticks see the turns before them
+                publish_bpm_delta(&bpm_delta);
+
+                // Handle bpm set command
+                if (tick.direction == 0)
+                {
+                    handle_select(prev_direction, &tick);
+                }
+                else if (tick.direction == 10)
+                {
+                    handle_long_press(encoder, &tick);
+                }
+                // Handle switch press edge for tap tempo
+                else if (tick.direction == 20)
+                {
+                    handle_tap(&tick);
+                }
+                else
+                {
+                    ESP_LOGW(TAG, "Unknown tick direction: %d", tick.direction);
+                }
                 prev_direction = tick.direction;
-                change_bpm(bpm_delta);
-            }
-            // Handle up click and get multiplier for changing the bpm value
-            else if (tick.direction == 1)
+            } while (xQueueReceive(encoder_tick_queue, &tick, 0));
+            publish_bpm_delta(&bpm_delta);
+
+            // Report ticks lost to a full queue, turns are kept but switch events are not
+            uint32_t overflows = encoder_reader_get_queue_overflows(encoder);
+            if (overflows != encoder_stats.overflows)
             {
-                int8_t bpm_delta = handle_up_down(prev_direction, &tick, &action_up);
-                prev_direction = tick.direction;
-                change_bpm(bpm_delta);
+                ESP_LOGW(TAG, "Encoder queue full, %" PRIu32 " ticks dropped.", overflows - encoder_stats.overflows);
+                encoder_stats.overflows = overflows;
             }
-            else
+
+            // Log the counters periodically, publishes against detents show how much the draining folds
+            if (ENC_STATS_LOG_INTERVAL > 0 && encoder_stats.wakeups % ENC_STATS_LOG_INTERVAL == 0)
             {
-                ESP_LOGW(TAG, "Unknown tick direction: %d", tick.direction);
-                prev_direction = tick.direction;
+                ESP_LOGI(TAG, "Encoder wakeups %" PRIu32 " ticks %" PRIu32 " detents %" PRIu32 " publishes %" PRIu32 " overflows %" PRIu32,
+                         encoder_stats.wakeups, encoder_stats.ticks, encoder_stats.detents, encoder_stats.publishes, encoder_stats.overflows);
             }
         }
         // Revert any change in BPM not selected with unconfirmed changes and no action for too long
@@ -189,15 +326,18 @@ esp_err_t start_encoder_handler(void)
         return ESP_FAIL;
     }
 
+    // Start with no taps and from the slowest step
+    tap_tempo_init(&tap_tempo);
+    encoder_acceleration_init(&acceleration);
+
     static encoder_reader_handle_t encoder;
     const encoreder_reader_settings_t encoder_reader_settings = {
         .pin_a = ENC_A_PIN,
         .pin_b = ENC_B_PIN,
         .pin_sw = ENC_SW_PIN,
-        .a_debounce_us = ENC_A_DEBOUNCE,
-        .b_debounce_us = ENC_B_DEBOUNCE,
         .sw_debounce_us = ENC_SW_DEBOUNCE,
         .sw_longpress_us = ENC_SW_LONGPRESS,
+        .sw_press_lockout_us = ENC_SW_PRESS_LOCKOUT,
         .tick_queue = encoder_action_queue,
     };
 
@@ -0,0 +1,103 @@
+#include "glyph_store.h"
+#include <stdbool.h>
+
+/**
+ * @brief Decoded glyph in the cache
+ */
+typedef struct
+{
+    uint8_t glyph;     // Glyph id, GLYPH_COUNT when empty
+    uint32_t last_use; // Request counter value of the last use
+    uint8_t image[GLYPH_IMAGE_SIZE];
+} glyph_slot_t;
+
+static glyph_slot_t cache[GLYPH_CACHE_SLOTS];
+static bool cache_initialized = false;
+static uint32_t use_counter = 0;
+static glyph_store_stats_t glyph_stats = {0};
+
+/**
+ * Decode one run length encoded image
+ *
+ * @param uint8_t glyph Glyph id.
+ * @param uint8_t* image Output, GLYPH_IMAGE_SIZE bytes.
+ * @return void.
+ */
+static void decode(uint8_t glyph, uint8_t *image)
+{
+    const uint8_t *data = &glyph_store_data[glyph_store_index[glyph]];
+    const uint8_t *end = &glyph_store_data[glyph_store_index[glyph + 1]];
+    uint8_t *out = image;
+    uint8_t *out_end = image + GLYPH_IMAGE_SIZE;
+    while (data < end && out < out_end)
+    {
+        uint8_t control = *data++;
+        if (control < 0x80)
+        {
+            // Literal bytes
+            uint8_t count = control + 1;
+            while (count-- > 0 && out < out_end)
+            {
+                *out++ = *data++;
+            }
+        }
+        else
+        {
+            // Run of one byte
+            uint8_t count = control - 0x80 + 2;
+            uint8_t value = *data++;
+            while (count-- > 0 && out < out_end)
+            {
+                *out++ = value;
+            }
+        }
+    }
+}
+
+const uint8_t *glyph_store_get(uint8_t glyph)
+{
+    if (glyph >= GLYPH_COUNT)
+    {
+        glyph = 0;
+    }
+    if (!cache_initialized)
+    {
+        for (int slot = 0; slot < GLYPH_CACHE_SLOTS; slot++)
+        {
+            cache[slot].glyph = GLYPH_COUNT;
+        }
+        cache_initialized = true;
+    }
+
+    // Look the glyph up, remembering the least recently used slot in case it is not there
+    use_counter++;
+    glyph_slot_t *oldest = &cache[0];
+    for (int slot = 0; slot < GLYPH_CACHE_SLOTS; slot++)
+    {
+        if (cache[slot].glyph == glyph)
+        {
+            glyph_stats.hits++;
+            cache[slot].last_use = use_counter;
+            return cache[slot].image;
+        }
+        if (cache[slot].glyph == GLYPH_COUNT || cache[slot].last_use < oldest->last_use)
+        {
+            oldest = &cache[slot];
+            if (oldest->glyph == GLYPH_COUNT)
+            {
+                break; // Slots are filled in order, nothing follows the first empty one
+            }
+        }
+    }
+
+    glyph_stats.misses++;
+    decode(glyph, oldest->image);
+    oldest->glyph = glyph;
+    oldest->last_use = use_counter;
+    return oldest->image;
+}
+
+void glyph_store_get_stats(glyph_store_stats_t *stats)
+{
+    *stats = glyph_stats;
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "screen_handler.h"
 #include "output_handler.h"
 #include "shared_variables.h"
+#include "midi_sync.h"
 
 void app_main(void)
 {
@@ -12,11 +13,11 @@ void app_main(void)
     // Return value for handling errors from  the called functions
     esp_err_t ret;
 
-    // Initialize semaphores for handling the shared variables
-    ret = init_semaphores();
+    // Initialize the shared variables
+    ret = init_shared_variables();
     if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to initialize semaphores: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to initialize shared variables: %s", esp_err_to_name(ret));
         esp_restart();
     }
 
@@ -43,4 +44,15 @@ void app_main(void)
         ESP_LOGE(TAG, "Failed to start the output handler: %s", esp_err_to_name(ret));
         esp_restart();
     }
+
+    // Setup and start following the MIDI clock input
+    if (MIDI_SYNC_ENABLED)
+    {
+        ret = start_midi_sync();
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to start the MIDI sync: %s", esp_err_to_name(ret));
+            esp_restart();
+        }
+    }
 }
\ No newline at end of file
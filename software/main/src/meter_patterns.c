@@ -0,0 +1,39 @@
+#include "meter_patterns.h"
+#include "resources.h"
+#include "esp_attr.h"
+
+// Beats in each bar, named so every pattern can be checked against the packed fields
+#define BEATS_4_4 4
+#define BEATS_3_4 3
+#define BEATS_2_4 2
+#define BEATS_5_4 5
+#define BEATS_6_8 6
+#define BEATS_7_8 7
+#define BEATS_12_8 12
+
+// Bar patterns in the order the signature mode cycles through them. Accents are listed from the first beat,
+// S = strong, M = medium, W = weak.
+static const meter_pattern_t meter_patterns[METER_PATTERN_COUNT] = {
+    {.accents = 0x57, .groups = 0x1, .length = BEATS_4_4, .glyph = 0},         // 4/4: S W W W
+    {.accents = 0x17, .groups = 0x1, .length = BEATS_3_4, .glyph = 1},         // 3/4: S W W
+    {.accents = 0x7, .groups = 0x1, .length = BEATS_2_4, .glyph = 2},          // 2/4: S W
+    {.accents = 0x197, .groups = 0x9, .length = BEATS_5_4, .glyph = 3},        // 5/4 as 3+2: S W W M W
+    {.accents = 0x597, .groups = 0x9, .length = BEATS_6_8, .glyph = 4},        // 6/8 as 3+3: S W W M W W
+    {.accents = 0x1667, .groups = 0x15, .length = BEATS_7_8, .glyph = 5},      // 7/8 as 2+2+3: S W M W M W W
+    {.accents = 0x596597, .groups = 0x249, .length = BEATS_12_8, .glyph = 6},  // 12/8 as 3+3+3+3: S W W M W W M W W M W W
+};
+
+_Static_assert(METER_PATTERN_COUNT <= 128, "Pattern index must fit the packed signature mode");
+_Static_assert(METER_PATTERN_COUNT <= SIGNATURE_IMAGES, "Every pattern needs a signature image");
+_Static_assert(BEATS_4_4 <= METER_MAX_BEATS, "4/4 does not fit the packed accents");
+_Static_assert(BEATS_3_4 <= METER_MAX_BEATS, "3/4 does not fit the packed accents");
+_Static_assert(BEATS_2_4 <= METER_MAX_BEATS, "2/4 does not fit the packed accents");
+_Static_assert(BEATS_5_4 <= METER_MAX_BEATS, "5/4 does not fit the packed accents");
+_Static_assert(BEATS_6_8 <= METER_MAX_BEATS, "6/8 does not fit the packed accents");
+_Static_assert(BEATS_7_8 <= METER_MAX_BEATS, "7/8 does not fit the packed accents");
+_Static_assert(BEATS_12_8 <= METER_MAX_BEATS, "12/8 does not fit the packed accents");
+
+const meter_pattern_t *IRAM_ATTR get_meter_pattern(uint16_t index)
+{
+    return &meter_patterns[index % METER_PATTERN_COUNT];
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "midi_clock.h"
+#include "settings.h"
+#include "driver/uart.h"
+#include "hal/uart_ll.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+
+static _Atomic uint32_t dropped_messages = 0;
+
+esp_err_t midi_clock_init(void)
+{
+    // Create tag
+    static const char *TAG = "midi_clock_init";
+
+    // 31250 baud 8N1, TX only
+    uart_config_t uart_config = {
+        .baud_rate = MIDI_BAUD_RATE,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+    esp_err_t ret = uart_param_config(MIDI_UART_NUM, &uart_config);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "MIDI UART configuration failed.");
+        return ret;
+    }
+    ret = uart_set_pin(MIDI_UART_NUM, MIDI_TX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "MIDI UART pin setup failed.");
+        return ret;
+    }
+    return ESP_OK;
+}
+
+bool IRAM_ATTR midi_clock_send(const uint8_t *bytes, uint8_t length)
+{
+    uart_dev_t *hw = UART_LL_GET_HW(MIDI_UART_NUM);
+    if (uart_ll_get_txfifo_len(hw) < length)
+    {
+        atomic_fetch_add_explicit(&dropped_messages, 1, memory_order_relaxed);
+        return false;
+    }
+    uart_ll_write_txfifo(hw, bytes, length);
+    return true;
+}
+
+bool IRAM_ATTR midi_clock_send_song_position(uint16_t position)
+{
+    uint8_t message[3] = {MIDI_SONG_POSITION, position & 0x7F, (position >> 7) & 0x7F};
+    return midi_clock_send(message, sizeof(message));
+}
+
+uint32_t midi_clock_get_dropped(void)
+{
+    return atomic_load_explicit(&dropped_messages, memory_order_relaxed);
+}
\ No newline at end of file
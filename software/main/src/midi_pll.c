@@ -0,0 +1,103 @@
+#include "midi_pll.h"
+#include "midi_clock.h"
+#include <string.h>
+
+#define FIXED(us) ((uint64_t)(us) << MIDI_PLL_FRACTION_BITS)
+
+void midi_pll_init(midi_pll_t *pll)
+{
+    memset(pll, 0, sizeof(*pll));
+}
+
+void midi_pll_start(midi_pll_t *pll)
+{
+    // Count the first pulse after Start as pulse 0
+    pll->pulse = UINT32_MAX;
+}
+
+void midi_pll_input(midi_pll_t *pll, uint64_t time)
+{
+    pll->pulse++;
+    switch (pll->state)
+    {
+    case MIDI_PLL_IDLE:
+        pll->phase = FIXED(time);
+        pll->state = MIDI_PLL_MEASURING;
+        return;
+    case MIDI_PLL_MEASURING:
+    {
+        // Take the first period as is, a period out of range restarts the measurement
+        uint64_t period = time - (pll->phase >> MIDI_PLL_FRACTION_BITS);
+        pll->phase = FIXED(time);
+        if (period >= MIDI_PLL_MIN_PERIOD_US && period <= MIDI_PLL_MAX_PERIOD_US)
+        {
+            pll->period = FIXED(period);
+            pll->error_average = 0;
+            pll->state = MIDI_PLL_TRACKING;
+        }
+        return;
+    }
+    case MIDI_PLL_TRACKING:
+        break;
+    }
+
+    // Phase detector: error of the pulse against the prediction
+    uint64_t predicted = pll->phase + pll->period;
+    int64_t error = (int64_t)(FIXED(time) - predicted);
+    uint64_t magnitude = (error < 0) ? -error : error;
+
+    // Lost pulses or a jump in the clock, measure again
+    if (magnitude > pll->period)
+    {
+        pll->phase = FIXED(time);
+        pll->state = MIDI_PLL_MEASURING;
+        pll->locked = false;
+        pll->lock_count = 0;
+        return;
+    }
+
+    // Loop filter: proportional correction of the phase, integral correction of the period.
+    // Fast gains pull in while acquiring, slow gains filter the jitter once locked.
+    uint8_t kp_shift = pll->locked ? MIDI_PLL_LOCKED_KP_SHIFT : MIDI_PLL_ACQUIRE_KP_SHIFT;
+    uint8_t ki_shift = pll->locked ? MIDI_PLL_LOCKED_KI_SHIFT : MIDI_PLL_ACQUIRE_KI_SHIFT;
+    pll->phase = predicted + (error >> kp_shift);
+    int64_t period = (int64_t)pll->period + (error >> ki_shift);
+    if (period < (int64_t)FIXED(MIDI_PLL_MIN_PERIOD_US))
+    {
+        period = FIXED(MIDI_PLL_MIN_PERIOD_US);
+    }
+    else if (period > (int64_t)FIXED(MIDI_PLL_MAX_PERIOD_US))
+    {
+        period = FIXED(MIDI_PLL_MAX_PERIOD_US);
+    }
+    pll->period = period;
+
+    // Lock detector on the averaged phase error, unlock with hysteresis
+    pll->error_average += ((int64_t)magnitude - (int64_t)pll->error_average) >> MIDI_PLL_ERROR_AVERAGE_SHIFT;
+    uint64_t limit = pll->period * MIDI_PLL_LOCK_PERCENT / 100;
+    if (pll->error_average <= limit)
+    {
+        if (pll->lock_count < MIDI_PLL_LOCK_PULSES)
+        {
+            pll->lock_count++;
+        }
+        pll->locked = pll->locked || pll->lock_count >= MIDI_PLL_LOCK_PULSES;
+    }
+    else
+    {
+        pll->lock_count = 0;
+        pll->locked = pll->locked && pll->error_average <= 2 * limit;
+    }
+}
+
+uint64_t midi_pll_next_beat_time(const midi_pll_t *pll)
+{
+    uint32_t pulses_left = MIDI_CLOCK_PPQN - pll->pulse % MIDI_CLOCK_PPQN;
+    return (pll->phase + pll->period * pulses_left) >> MIDI_PLL_FRACTION_BITS;
+}
+
+void midi_pll_beat_period(const midi_pll_t *pll, uint64_t *period_num, uint32_t *period_den)
+{
+    *period_num = pll->period * MIDI_CLOCK_PPQN;
+    *period_den = 1 << MIDI_PLL_FRACTION_BITS;
+}
\ No newline at end of file
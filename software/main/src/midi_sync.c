@@ -0,0 +1,301 @@
+#include "midi_sync.h"
+#include "midi_clock.h"
+#include "midi_pll.h"
+#include "beat_scheduler.h"
+#include "output_handler.h"
+#include "shared_variables.h"
+#include "settings.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/uart.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+
+#define FRAME_US (10 * 1000000 / MIDI_BAUD_RATE) // Start, 8 data and stop bits
+
+// Falling edges of the RX line stamped by the edge ISR, single producer single consumer ring to the task
+static uint64_t edge_ring[MIDI_SYNC_EDGE_RING_SIZE];
+static _Atomic uint32_t edge_ring_head = 0; // Written by the ISR only
+static _Atomic uint32_t edge_ring_tail = 0; // Written by the task only
+
+/**
+ * Stamp a falling edge of the RX line. Every byte starts with one, so the stamps carry the receive times
+ * of the bytes without the latency of the UART event and the task.
+ *
+ * @param void* arg Unused.
+ * @return void.
+ */
+static void rx_edge_isr_handler(void *arg)
+{
+    uint64_t time = output_handler_get_time();
+    uint32_t head = atomic_load_explicit(&edge_ring_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&edge_ring_tail, memory_order_acquire);
+    if (head - tail >= MIDI_SYNC_EDGE_RING_SIZE)
+    {
+        return; // The task is behind, its bytes fall back to the read time
+    }
+    edge_ring[head % MIDI_SYNC_EDGE_RING_SIZE] = time;
+    atomic_store_explicit(&edge_ring_head, head + 1, memory_order_release);
+}
+
+/**
+ * Count the falling edges of a byte on the line: the start bit and every one followed by a zero in the
+ * data bits, sent least significant bit first. The stop bit is high so the last data bit adds none.
+ *
+ * @param uint8_t byte Received byte.
+ * @return uint8_t falling edges, 1 for the timing clock.
+ */
+static uint8_t falling_edges(uint8_t byte)
+{
+    return 1 + __builtin_popcount(byte & ~(byte >> 1) & 0x7F);
+}
+
+/**
+ * Take the stamps of a byte from the edge ring and return the time of its start bit
+ *
+ * @param uint8_t byte Received byte, the next one in the order of the line.
+ * @param uint64_t fallback Time returned if the stamps of the byte were lost.
+ * @return uint64_t receive time of the byte on the output timer.
+ */
+static uint64_t take_byte_time(uint8_t byte, uint64_t fallback)
+{
+    uint32_t tail = atomic_load_explicit(&edge_ring_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&edge_ring_head, memory_order_acquire);
+    uint8_t edges = falling_edges(byte);
+    if (head - tail < edges)
+    {
+        // Stamps were lost, drop the partial ones so the following bytes line up again
+        atomic_store_explicit(&edge_ring_tail, head, memory_order_release);
+        return fallback;
+    }
+    uint64_t time = edge_ring[tail % MIDI_SYNC_EDGE_RING_SIZE];
+    atomic_store_explicit(&edge_ring_tail, tail + edges, memory_order_release);
+    return time;
+}
+
+/**
+ * Drop stamps left over once every received byte has been read, e.g. from a glitch on the line. Stamps of
+ * a byte still arriving are younger than two frames and are kept.
+ *
+ * @param uint64_t now Current time on the output timer.
+ * @return void.
+ */
+static void drop_stale_edges(uint64_t now)
+{
+    uint32_t tail = atomic_load_explicit(&edge_ring_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&edge_ring_head, memory_order_acquire);
+    while (tail != head && edge_ring[tail % MIDI_SYNC_EDGE_RING_SIZE] + 2 * FRAME_US < now)
+    {
+        tail++;
+    }
+    atomic_store_explicit(&edge_ring_tail, tail, memory_order_release);
+}
+
+/**
+ * Show the followed tempo on the screen, rounded to whole bpm. A candidate the user is changing is kept.
+ *
+ * @param const midi_pll_t* pll Locked PLL.
+ * @return void.
+ */
+static void show_followed_bpm(const midi_pll_t *pll)
+{
+    uint64_t period_num;
+    uint32_t period_den;
+    midi_pll_beat_period(pll, &period_num, &period_den);
+    int32_t bpm = (int32_t)((60000000ULL * period_den + period_num / 2) / period_num);
+    if (bpm != get_selected_bpm())
+    {
+        set_followed_bpm(bpm);
+    }
+}
+
+/**
+ * Handle one received byte. Only the realtime messages are followed, everything else is ignored.
+ *
+ * @param midi_pll_t* pll Clock PLL.
+ * @param uint8_t byte Received byte.
+ * @param uint64_t time Receive time on the output timer.
+ * @return void.
+ */
+static void handle_byte(midi_pll_t *pll, uint8_t byte, uint64_t time)
+{
+    // Create tag
+    static const char *TAG = "midi_sync";
+
+    switch (byte)
+    {
+    case MIDI_TIMING_CLOCK:
+    {
+        bool was_locked = pll->locked;
+        midi_pll_input(pll, time);
+        if (pll->locked != was_locked)
+        {
+            ESP_LOGI(TAG, "MIDI clock %s.", pll->locked ? "locked" : "lost lock, running free");
+        }
+        if (!pll->locked)
+        {
+            break;
+        }
+
+        // Once a beat, halfway between the beats, the pending beat is moved onto the predicted one
+        if (pll->pulse % MIDI_CLOCK_PPQN == MIDI_SYNC_PULSE)
+        {
+            uint64_t period_num;
+            uint32_t period_den;
+            midi_pll_beat_period(pll, &period_num, &period_den);
+            output_handler_sync(midi_pll_next_beat_time(pll), period_num, period_den);
+        }
+        else if (pll->pulse % MIDI_CLOCK_PPQN == 0)
+        {
+            show_followed_bpm(pll);
+        }
+        break;
+    }
+    case MIDI_START:
+    {
+        // The next pulse is the downbeat, move the pending beat onto it now instead of on the next sync pulse
+        midi_pll_start(pll);
+        reset_beat();
+        uint64_t downbeat = time;
+        uint64_t period_num = US_PER_MINUTE;
+        uint32_t period_den = get_selected_bpm();
+        if (pll->state == MIDI_PLL_TRACKING)
+        {
+            uint64_t next_pulse = (pll->phase + pll->period) >> MIDI_PLL_FRACTION_BITS;
+            downbeat = (next_pulse > time) ? next_pulse : time;
+            midi_pll_beat_period(pll, &period_num, &period_den);
+        }
+        output_handler_sync(downbeat, period_num, period_den);
+        break;
+    }
+    case MIDI_STOP:
+        // Keep following the clock, a master keeps sending it while stopped
+        break;
+    default:
+        break;
+    }
+}
+
+void midi_sync_task(void *arg)
+{
+    // Create tag
+    static const char *TAG = "midi_sync_task";
+    ESP_LOGI(TAG, "MIDI sync task started.");
+
+    QueueHandle_t uart_queue = (QueueHandle_t)arg;
+    midi_pll_t pll;
+    midi_pll_init(&pll);
+    uart_event_t event;
+    uint8_t data[MIDI_SYNC_RX_BUFFER];
+
+    while (1)
+    {
+        // Run free again if the clock stops
+        if (xQueueReceive(uart_queue, &event, pdMS_TO_TICKS(MIDI_SYNC_TIMEOUT)) != pdTRUE)
+        {
+            if (pll.state != MIDI_PLL_IDLE)
+            {
+                ESP_LOGI(TAG, "MIDI clock stopped, running free.");
+                midi_pll_init(&pll);
+            }
+            continue;
+        }
+
+        // Recover from an overflow, the PLL rides through the lost pulses
+        if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL)
+        {
+            ESP_LOGW(TAG, "MIDI input overflow.");
+            uart_flush_input(MIDI_UART_NUM);
+            xQueueReset(uart_queue);
+            atomic_store_explicit(&edge_ring_tail, atomic_load(&edge_ring_head), memory_order_release);
+            continue;
+        }
+        if (event.type != UART_DATA)
+        {
+            continue;
+        }
+
+        // Every byte gets the time of its start bit, the read time is only used if its stamps were lost
+        uint64_t time = output_handler_get_time();
+        int length = uart_read_bytes(MIDI_UART_NUM, data, event.size < sizeof(data) ? event.size : sizeof(data), 0);
+        for (int i = 0; i < length; i++)
+        {
+            handle_byte(&pll, data[i], take_byte_time(data[i], time));
+        }
+        size_t buffered = 0;
+        if (uart_get_buffered_data_len(MIDI_UART_NUM, &buffered) == ESP_OK && buffered == 0)
+        {
+            drop_stale_edges(output_handler_get_time());
+        }
+    }
+}
+
+esp_err_t start_midi_sync(void)
+{
+    // Create tag
+    static const char *TAG = "start_midi_sync";
+
+    // The UART is shared with the clock output
+    esp_err_t ret = midi_clock_init();
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    ret = uart_set_pin(MIDI_UART_NUM, UART_PIN_NO_CHANGE, MIDI_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "MIDI RX pin setup failed.");
+        return ret;
+    }
+
+    // RX only driver, the clock output writes the TX FIFO directly
+    QueueHandle_t uart_queue;
+    ret = uart_driver_install(MIDI_UART_NUM, MIDI_SYNC_RX_BUFFER, 0, MIDI_SYNC_QUEUE_LENGTH, &uart_queue, 0);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "MIDI UART driver install failed.");
+        return ret;
+    }
+
+    // Interrupt on every byte so the bytes are read while their stamps are still in the edge ring
+    ret = uart_set_rx_full_threshold(MIDI_UART_NUM, 1);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "MIDI RX threshold setup failed.");
+        return ret;
+    }
+
+    // Stamp the falling edges of the RX line, the ISR service is shared with the encoder reader
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+    {
+        ESP_LOGE(TAG, "GPIO ISR service install failed.");
+        return ret;
+    }
+    ret = gpio_set_intr_type(MIDI_RX_PIN, GPIO_INTR_NEGEDGE);
+    if (ret == ESP_OK)
+    {
+        ret = gpio_isr_handler_add(MIDI_RX_PIN, rx_edge_isr_handler, NULL);
+    }
+    if (ret == ESP_OK)
+    {
+        ret = gpio_intr_enable(MIDI_RX_PIN);
+    }
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "MIDI RX edge interrupt setup failed.");
+        return ret;
+    }
+
+    // Setup task parameters and start the task
+    BaseType_t x_returned;
+    x_returned = xTaskCreate(midi_sync_task, "midi_sync_task", 3072, (void *)uart_queue, 11, NULL);
+    if (x_returned != pdPASS)
+    {
+        ESP_LOGE(TAG, "MIDI sync task creation failed.");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
\ No newline at end of file
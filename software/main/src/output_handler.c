@@ -1,6 +1,6 @@
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
+#include "freertos/task.h"
 #include "settings.h"
 #include "esp_err.h"
 #include "shared_variables.h"
@@ -8,9 +8,356 @@
 #include "output_handler.h"
 #include "driver/gptimer.h"
 #include "resources.h"
+#include "beat_scheduler.h"
+#include "beat_timing.h"
+#include "tempo_automation.h"
+#include "rhythm_timeline.h"
+#include "meter_patterns.h"
+#include "midi_clock.h"
+#include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+
+#define TEMPO_COMMAND_SLOTS 4    // Pending tempo changes
+#define ALARM_LEAD_US 1000 // Minimum lead when an alarm is rescheduled
+#define BEAT_RING_SIZE 8   // Beats waiting for the task, power of two
+
+// Click length of each accent level, indexed by meter_accent_t
+static const uint32_t accent_durations[] = {
+    0,
+    OUTPUT_ACTIVATION_DURATION * 1000,
+    OUTPUT_ACTIVATION_DURATION * 1500,
+    OUTPUT_ACTIVATION_DURATION * 2000,
+};
+
+// Tempo change waiting for its beat
+typedef struct
+{
+    uint16_t bpm;
+    tempo_apply_t apply;
+    uint64_t beat;
+} tempo_command_t;
+
+// Beat handed from the beat ISR to the task
+typedef struct
+{
+    uint32_t sequence;     // Beat timing sequence number
+    uint64_t beat;         // Beat index on the timeline
+    uint64_t time;         // Scheduled timestamp of the beat
+    uint8_t bar_position;  // Position in the bar, 1 is the downbeat
+    meter_accent_t accent; // Accent level played
+} beat_event_t;
+
+// Playback state of the tempo automation
+typedef enum
+{
+    AUTOMATION_IDLE,
+    AUTOMATION_PENDING, // Waiting for the next downbeat
+    AUTOMATION_RUNNING,
+} automation_state_t;
+
+// Playback state of the MIDI clock
+typedef enum
+{
+    MIDI_CLOCK_STOPPED,
+    MIDI_CLOCK_STARTING, // Waiting for the next downbeat to send Start
+    MIDI_CLOCK_RUNNING,
+} midi_clock_state_t;
+
+// Output handler state shared between the timer ISRs and the task
+typedef struct
+{
+    TaskHandle_t task;
+    beat_event_t beat_ring[BEAT_RING_SIZE]; // Single producer single consumer ring from the beat ISR to the task
+    _Atomic uint32_t beat_ring_head;        // Written by the ISR only
+    _Atomic uint32_t beat_ring_tail;        // Written by the task only
+    _Atomic uint32_t dropped_beats;         // Beats lost because the ring was full
+    gptimer_handle_t beat_timer;
+    gptimer_handle_t pulse_timer;
+    beat_scheduler_t scheduler;
+    uint64_t last_beat_time;
+    tempo_command_t tempo_commands[TEMPO_COMMAND_SLOTS];
+    uint8_t tempo_command_head;
+    uint8_t tempo_command_count;
+    tempo_automation_t automations[2];         // Curve being played and the one being copied
+    tempo_automation_t *automation;            // Curve being played
+    automation_state_t automation_state;
+    rhythm_timeline_t timelines[2];            // Timeline being played and the one being built
+    const rhythm_timeline_t *timeline;         // Timeline being played
+    const rhythm_timeline_t *pending_timeline; // Timeline to switch to on the next beat
+    uint16_t event;                            // Index of the pending event in the timeline
+    uint64_t event_time;                       // Timestamp of the pending event
+    uint64_t click_start;                      // Rising edge of the click started by the current alarm, UINT64_MAX if none
+    uint64_t pulse_end;                        // Falling edge of the active pulse on the pulse timer
+    output_overrun_policy_t overrun_policy;
+    output_overrun_counters_t overrun_counters;
+    midi_clock_state_t midi_clock_state;
+    uint8_t clock_pulse;                       // Next clock pulse after clock_beat, 24 is on the following beat
+    uint64_t clock_beat;                       // Index of the beat the pending clock pulse counts from
+    uint64_t clock_time;                       // Timestamp of the next clock pulse, UINT64_MAX when stopped
+    uint32_t clock_count;                      // Clock pulses sent since Start
+    uint64_t alarm_time;                       // Alarm of the beat timer, the earlier of event_time and clock_time
+    portMUX_TYPE lock;                         // Protects everything the beat ISR uses
+} output_context_t;
+
+static output_context_t output_context = {.lock = portMUX_INITIALIZER_UNLOCKED, .overrun_policy = OUTPUT_OVERRUN_POLICY};
+
+/**
+ * Hand a played beat to the task. Lock free, the ISR is the only producer.
+ *
+ * @param output_context_t* context Output handler context.
+ * @param const beat_event_t* beat Played beat.
+ * @param BaseType_t* high_task_awoken Set if the task was woken.
+ * @return void.
+ */
+static void IRAM_ATTR publish_beat(output_context_t *context, const beat_event_t *beat, BaseType_t *high_task_awoken)
+{
+    uint32_t head = atomic_load_explicit(&context->beat_ring_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&context->beat_ring_tail, memory_order_acquire);
+    if (head - tail >= BEAT_RING_SIZE)
+    {
+        // The task is behind, it sees the gap in the beat indexes
+        atomic_fetch_add_explicit(&context->dropped_beats, 1, memory_order_relaxed);
+        return;
+    }
+    context->beat_ring[head % BEAT_RING_SIZE] = *beat;
+    atomic_store_explicit(&context->beat_ring_head, head + 1, memory_order_release);
+    vTaskNotifyGiveFromISR(context->task, high_task_awoken);
+}
+
+/**
+ * Apply the queued tempo changes that are due on the beat being played. Call with the lock held.
+ *
+ * @param output_context_t* context Output handler context.
+ * @param uint8_t bar_position Position of the beat in the bar, 1 is the downbeat.
+ * @return void.
+ */
+static void IRAM_ATTR apply_tempo_commands(output_context_t *context, uint8_t bar_position)
+{
+    while (context->tempo_command_count > 0)
+    {
+        tempo_command_t *command = &context->tempo_commands[context->tempo_command_head];
+        bool due = (command->apply == TEMPO_APPLY_NEXT_DOWNBEAT && bar_position == 1) ||
+                   (command->apply == TEMPO_APPLY_AT_BEAT && context->scheduler.beat >= command->beat);
+        if (!due)
+        {
+            break;
+        }
+
+        // The beat keeps its time, the interval after it uses the new tempo. A manual change overrides the automation.
+        beat_scheduler_set_bpm(&context->scheduler, command->bpm);
+        context->automation_state = AUTOMATION_IDLE;
+        context->tempo_command_head = (context->tempo_command_head + 1) % TEMPO_COMMAND_SLOTS;
+        context->tempo_command_count--;
+    }
+}
+
+/**
+ * Move the timeline to the next beat, following the tempo automation while it runs. Call with the lock held.
+ *
+ * @param output_context_t* context Output handler context.
+ * @param uint8_t bar_position Position of the beat being played in the bar, 1 is the downbeat.
+ * @return uint64_t timestamp of the next beat.
+ */
+static uint64_t IRAM_ATTR next_beat_time(output_context_t *context, uint8_t bar_position)
+{
+    if (context->automation_state == AUTOMATION_PENDING && bar_position == 1)
+    {
+        context->automation_state = AUTOMATION_RUNNING;
+    }
+    if (context->automation_state == AUTOMATION_RUNNING)
+    {
+        if (!tempo_automation_done(context->automation))
+        {
+            return beat_scheduler_advance_interval(&context->scheduler, tempo_automation_next_interval(context->automation));
+        }
+
+        // Continue with the last tempo of the curve once it has been played
+        beat_scheduler_set_bpm(&context->scheduler, context->automation->last_bpm);
+        context->automation_state = AUTOMATION_IDLE;
+    }
+    return beat_scheduler_advance(&context->scheduler);
+}
+
+/**
+ * Calculate the timestamp of the pending event. Events between beats are placed on the grid between
+ * the last beat and the next beat with the swing applied, so they follow tempo changes without accumulating error.
+ * Call with the lock held.
+ *
+ * @param const output_context_t* context Output handler context.
+ * @return uint64_t timestamp of the pending event.
+ */
+static uint64_t IRAM_ATTR pending_event_time(const output_context_t *context)
+{
+    const rhythm_event_t *event = &context->timeline->events[context->event];
+    if (event->tick == 0)
+    {
+        return context->scheduler.time;
+    }
+    return beat_scheduler_subdivision_time(&context->scheduler, context->last_beat_time, event->tick, context->timeline->ticks_per_beat);
+}
+
+/**
+ * Calculate the timestamp of the next MIDI clock pulse. The pulses divide the interval between the last beat
+ * and the next beat, so they stay locked to the clicks. The pulse counts from its own beat index, so a pulse
+ * sent on the beat before a late beat alarm waits for that beat instead of counting from the stale one.
+ * Call with the lock held.
+ *
+ * @param const output_context_t* context Output handler context.
+ * @return uint64_t timestamp of the next pulse, UINT64_MAX if the clock is not running or waits for its beat.
+ */
+static uint64_t IRAM_ATTR pending_clock_time(const output_context_t *context)
+{
+    if (context->midi_clock_state != MIDI_CLOCK_RUNNING || context->clock_beat >= context->scheduler.beat)
+    {
+        return UINT64_MAX;
+    }
+
+    // Pulses of a beat before the last played one are late, send them right away
+    if (context->clock_beat + 1 < context->scheduler.beat)
+    {
+        return context->last_beat_time;
+    }
+    uint64_t period = context->scheduler.time - context->last_beat_time;
+    return context->last_beat_time + period * context->clock_pulse / MIDI_CLOCK_PPQN;
+}
+
+/**
+ * Set the beat timer alarm to the earlier of the pending event and the next clock pulse. Call with the lock held.
+ *
+ * @param output_context_t* context Output handler context.
+ * @return esp_err_t error from setting the alarm.
+ */
+static esp_err_t IRAM_ATTR set_next_alarm(output_context_t *context)
+{
+    context->alarm_time = (context->clock_time < context->event_time) ? context->clock_time : context->event_time;
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = context->alarm_time};
+    return gptimer_set_alarm_action(context->beat_timer, &alarm_config);
+}
+
+/**
+ * Start a click and apply the overrun policy if the previous pulse is still active. Call with the lock held.
+ *
+ * @param output_context_t* context Output handler context.
+ * @param uint32_t duration_us Requested click length, cut to the duty limit by limit_click once the next event is known.
+ * @param bool led_on Turn the led on for the click.
+ * @return void.
+ */
+static void IRAM_ATTR play_click(output_context_t *context, uint32_t duration_us, bool led_on)
+{
+    uint64_t now = 0;
+    gptimer_get_raw_count(context->pulse_timer, &now);
+    if (now < context->pulse_end)
+    {
+        output_overrun_counters_t *counters = &context->overrun_counters;
+        if (context->overrun_policy == OUTPUT_OVERRUN_DROP)
+        {
+            counters->dropped++;
+            counters->overruns++;
+            return;
+        }
+
+        // The output stays high, the pulse ends after the new click
+        counters->coalesced++;
+        counters->overruns++;
+    }
+    context->click_start = now;
+    click(duration_us, led_on);
+}
+
+/**
+ * Cut the click started by this alarm to a duty fraction of its period, the time until the next event.
+ * The output was raised on the event itself, only its falling edge is moved. Call with the lock held.
+ *
+ * @param output_context_t* context Output handler context.
+ * @param uint64_t period Time from the played event to the next event.
+ * @return void.
+ */
+static void IRAM_ATTR limit_click(output_context_t *context, uint64_t period)
+{
+    uint64_t limit = period * OUTPUT_MAX_DUTY_PERCENT / 100;
+    if (context->click_start == UINT64_MAX || context->pulse_end - context->click_start <= limit)
+    {
+        return;
+    }
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = context->click_start + limit};
+    context->pulse_end = alarm_config.alarm_count;
+    gptimer_set_alarm_action(context->pulse_timer, &alarm_config);
+    context->overrun_counters.shortened++;
+    context->overrun_counters.overruns++;
+}
 
 /**
- * Handle output timer alarms. Mark output to be activated and set new timer based on the current bpm
+ * Play a main beat: click with the bar accent, mark the beat to the task and move the timeline to the next beat.
+ * Call with the lock held.
+ *
+ * @param output_context_t* context Output handler context.
+ * @param const state_snapshot_t* state Shared state read for this beat.
+ * @param uint64_t alarm_time Scheduled time of the beat.
+ * @param uint64_t isr_time ISR entry time.
+ * @param BaseType_t* high_task_awoken Set if a higher priority task was woken.
+ * @return void.
+ */
+static void IRAM_ATTR play_beat(output_context_t *context, const state_snapshot_t *state, uint64_t alarm_time, uint64_t isr_time, BaseType_t *high_task_awoken)
+{
+    // Raise the output on the beat itself, the pulse timer lowers it
+    uint64_t edge_time = 0;
+    const meter_pattern_t *pattern = get_meter_pattern(state->signature_mode);
+    meter_accent_t accent = meter_pattern_accent(pattern, state->current_beat);
+    if (state->system_state == SYSTEM_ON && accent != METER_ACCENT_MUTE)
+    {
+        play_click(context, accent_durations[accent], meter_pattern_group_start(pattern, state->current_beat));
+        gptimer_get_raw_count(context->beat_timer, &edge_time);
+    }
+
+    // Move the bar position to the next beat, the state word is lock free
+    if (state->system_state == SYSTEM_ON)
+    {
+        increment_beat_from_isr(high_task_awoken);
+    }
+
+    // Hand the beat to the task
+    beat_event_t beat = {
+        .sequence = beat_timing_record_isr(alarm_time, isr_time, edge_time),
+        .beat = context->scheduler.beat,
+        .time = alarm_time,
+        .bar_position = state->current_beat,
+        .accent = accent,
+    };
+    publish_beat(context, &beat, high_task_awoken);
+
+    // Start the MIDI clock on the downbeat, the first timing clock after Start marks this beat
+    if (context->midi_clock_state == MIDI_CLOCK_STARTING && state->current_beat == 1)
+    {
+        static const uint8_t start[] = {MIDI_SONG_POSITION, 0, 0, MIDI_START, MIDI_TIMING_CLOCK};
+        midi_clock_send(start, sizeof(start));
+        context->midi_clock_state = MIDI_CLOCK_RUNNING;
+        context->clock_count = 1;
+        context->clock_pulse = 1;
+        context->clock_beat = context->scheduler.beat;
+    }
+
+    // Re-phase the timeline from this beat if a tempo change is due
+    apply_tempo_commands(context, state->current_beat);
+
+    // Move to the next beat on the drift free timeline
+    context->last_beat_time = context->scheduler.time;
+    next_beat_time(context, state->current_beat);
+
+    // Switch to a new rhythm on the beat, its cycle starts from this beat
+    if (context->pending_timeline != NULL)
+    {
+        context->timeline = context->pending_timeline;
+        context->pending_timeline = NULL;
+        context->event = 0;
+    }
+}
+
+/**
+ * Handle output timer alarms. Play the pending event of the rhythm timeline and the MIDI clock pulse that are due
+ * and set the alarm to the following one
  *
  * @param timer Timer related to the event.
  * @param edata Event data.
@@ -22,35 +369,331 @@ static bool IRAM_ATTR output_timer_alarm(gptimer_handle_t timer, const gptimer_a
     // Create bool for high_task_awoken
     BaseType_t high_task_awoken = pdFALSE;
 
+    // Take the ISR entry time for the beat timing statistics
+    uint64_t isr_time = 0;
+    gptimer_get_raw_count(timer, &isr_time);
+
     // Unpack the necessary parameters
-    QueueHandle_t queue = (QueueHandle_t)user_data;
-    uint16_t bpm = get_selected_bpm();
+    output_context_t *context = (output_context_t *)user_data;
+    portENTER_CRITICAL_ISR(&context->lock);
 
-    // Send a "true" signal to the queue from the ISR
-    bool signal = true; // Just a simple boolean signal
-    xQueueSendFromISR(queue, &signal, &high_task_awoken);
+    // Ignore a stale alarm, the pending event was rescheduled by a tempo change
+    if (edata->alarm_value != context->alarm_time)
+    {
+        portEXIT_CRITICAL_ISR(&context->lock);
+        return false;
+    }
 
-    // Set new alarm based on the current bpm
-    gptimer_alarm_config_t alarm_config = {
-        .alarm_count = edata->alarm_value + 60 * 1000000 / bpm}; // bpm
-    gptimer_set_alarm_action(timer, &alarm_config);
+    context->click_start = UINT64_MAX;
+    if (context->event_time == edata->alarm_value)
+    {
+        state_snapshot_t state;
+        get_state_snapshot(&state);
+
+        // Main beats carry the bar accent, voices between the beats get a short click
+        if (context->timeline->events[context->event].voices & RHYTHM_MAIN_VOICE)
+        {
+            play_beat(context, &state, edata->alarm_value, isr_time, &high_task_awoken);
+        }
+        else if (state.system_state == SYSTEM_ON)
+        {
+            play_click(context, OUTPUT_SUBDIVISION_DURATION * 1000, false);
+        }
+        context->event = (context->event + 1) % context->timeline->event_count;
+    }
+
+    // Send the clock pulse after the click so the click edge is not delayed
+    if (context->clock_time == edata->alarm_value)
+    {
+        static const uint8_t timing_clock = MIDI_TIMING_CLOCK;
+        midi_clock_send(&timing_clock, 1);
+        context->clock_count++;
+        if (context->clock_pulse == MIDI_CLOCK_PPQN)
+        {
+            context->clock_beat++;
+        }
+        context->clock_pulse = context->clock_pulse % MIDI_CLOCK_PPQN + 1;
+    }
+
+    // Set new alarm to the next event or clock pulse, play late ones right away
+    uint64_t now = 0;
+    gptimer_get_raw_count(timer, &now);
+    context->event_time = pending_event_time(context);
+    limit_click(context, context->event_time - edata->alarm_value);
+    if (context->event_time < now + ALARM_LEAD_US)
+    {
+        context->overrun_counters.late_events++;
+        context->event_time = now + ALARM_LEAD_US;
+    }
+    context->clock_time = pending_clock_time(context);
+    if (context->clock_time < now + ALARM_LEAD_US)
+    {
+        context->overrun_counters.late_events++;
+        context->clock_time = now + ALARM_LEAD_US;
+    }
+    set_next_alarm(context);
+    portEXIT_CRITICAL_ISR(&context->lock);
     return (high_task_awoken == pdTRUE);
 }
 
-void click(bool long_click, bool led_on)
+/**
+ * Handle pulse timer alarms. End the click by setting the output and the led low
+ *
+ * @param timer Timer related to the event.
+ * @param edata Event data.
+ * @param user_data Arguments passed to the event.
+ * @return void.
+ */
+static bool IRAM_ATTR pulse_timer_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data)
 {
+    gpio_set_level(OUTPUT_PIN, false);
+    gpio_set_level(LED_PIN, false); // Set led off
+    return false;
+}
+
+void IRAM_ATTR click(uint32_t duration_us, bool led_on)
+{
+    // Schedule the falling edge on the free running pulse timer
+    uint64_t now = 0;
+    gptimer_get_raw_count(output_context.pulse_timer, &now);
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = now + duration_us};
+    output_context.pulse_end = alarm_config.alarm_count;
+
     gpio_set_level(LED_PIN, led_on);  // Set led on if requested
     gpio_set_level(OUTPUT_PIN, true); // Set pin high
-    if (long_click)
+    gptimer_set_alarm_action(output_context.pulse_timer, &alarm_config);
+}
+
+/**
+ * Move the pending event and clock pulse after the pending beat has been moved. The pending beat is played
+ * as soon as possible if its time has already passed. Call with the lock held.
+ *
+ * @param output_context_t* context Output handler context.
+ * @param uint64_t period_num Numerator of the beat period in microseconds.
+ * @param uint32_t period_den Denominator of the beat period.
+ * @return esp_err_t error from setting the alarm.
+ */
+static esp_err_t reschedule_pending(output_context_t *context, uint64_t period_num, uint32_t period_den)
+{
+    beat_scheduler_t *scheduler = &context->scheduler;
+    uint64_t now = 0;
+    gptimer_get_raw_count(context->beat_timer, &now);
+    if (scheduler->time < now + ALARM_LEAD_US)
+    {
+        beat_scheduler_rephase(scheduler, scheduler->beat, now + ALARM_LEAD_US, period_num, period_den);
+    }
+
+    // Move the pending event with the new period, skip to the beat if the new period already passed it
+    context->event_time = pending_event_time(context);
+    while (context->event_time < now + ALARM_LEAD_US)
+    {
+        context->event = (context->event + 1) % context->timeline->event_count;
+        context->event_time = pending_event_time(context);
+    }
+
+    // Clock pulses already due are sent right away so none of them is lost
+    context->clock_time = pending_clock_time(context);
+    if (context->clock_time < now + ALARM_LEAD_US)
     {
-        vTaskDelay(OUTPUT_ACTIVATION_DURATION * 2.0 / portTICK_PERIOD_MS); // Delay for y milliseconds
+        context->clock_time = now + ALARM_LEAD_US;
+    }
+    return set_next_alarm(context);
+}
+
+esp_err_t output_handler_set_tempo(uint16_t bpm, tempo_apply_t apply, uint64_t beat)
+{
+    if (bpm < 1 || bpm > 999 || apply > TEMPO_APPLY_AT_BEAT)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&output_context.lock);
+    beat_scheduler_t *scheduler = &output_context.scheduler;
+    if (apply == TEMPO_APPLY_NEXT_BEAT)
+    {
+        // A manual change overrides the automation
+        output_context.automation_state = AUTOMATION_IDLE;
+
+        // Re-phase from the last played beat so the pending beat already uses the new period
+        if (scheduler->beat > 0)
+        {
+            beat_scheduler_rephase(scheduler, scheduler->beat - 1, output_context.last_beat_time, US_PER_MINUTE, bpm);
+            beat_scheduler_advance(scheduler);
+        }
+        else
+        {
+            beat_scheduler_set_bpm(scheduler, bpm);
+        }
+
+        ret = reschedule_pending(&output_context, US_PER_MINUTE, bpm);
+    }
+    else if (output_context.tempo_command_count < TEMPO_COMMAND_SLOTS)
+    {
+        // Queue the change for the beat ISR
+        uint8_t tail = (output_context.tempo_command_head + output_context.tempo_command_count) % TEMPO_COMMAND_SLOTS;
+        output_context.tempo_commands[tail] = (tempo_command_t){.bpm = bpm, .apply = apply, .beat = beat};
+        output_context.tempo_command_count++;
     }
     else
     {
-        vTaskDelay(OUTPUT_ACTIVATION_DURATION / portTICK_PERIOD_MS); // Delay for y milliseconds
+        ret = ESP_ERR_NO_MEM;
     }
-    gpio_set_level(OUTPUT_PIN, false);
-    gpio_set_level(LED_PIN, false); // Set led off
+    portEXIT_CRITICAL(&output_context.lock);
+    return ret;
+}
+
+esp_err_t output_handler_start_automation(const tempo_automation_t *automation)
+{
+    if (automation == NULL || automation->segment_count == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Copy the segment table to the buffer the ISR is not using, so the caller does not need to keep it alive
+    portENTER_CRITICAL(&output_context.lock);
+    tempo_automation_t *copy = (output_context.automation == &output_context.automations[0]) ? &output_context.automations[1] : &output_context.automations[0];
+    portEXIT_CRITICAL(&output_context.lock);
+    memcpy(copy, automation, sizeof(*automation));
+    tempo_automation_rewind(copy);
+
+    // Only the pointer is swapped while the lock is held
+    portENTER_CRITICAL(&output_context.lock);
+    output_context.automation = copy;
+    output_context.automation_state = AUTOMATION_PENDING;
+    portEXIT_CRITICAL(&output_context.lock);
+    return ESP_OK;
+}
+
+void output_handler_stop_automation(void)
+{
+    portENTER_CRITICAL(&output_context.lock);
+    if (output_context.automation_state == AUTOMATION_RUNNING)
+    {
+        // Keep the current interval as the tempo from the next beat onwards. The Q32.32 interval becomes the period
+        // with one fractional bit less so the denominator fits, and the carried fraction becomes the remainder.
+        const tempo_automation_t *automation = output_context.automation;
+        beat_scheduler_rephase(&output_context.scheduler, output_context.scheduler.beat, output_context.scheduler.time,
+                               automation->interval >> 1, 1UL << (TEMPO_AUTOMATION_FRACTION_BITS - 1));
+        output_context.scheduler.remainder = automation->fraction >> 1;
+    }
+    output_context.automation_state = AUTOMATION_IDLE;
+    portEXIT_CRITICAL(&output_context.lock);
+}
+
+esp_err_t output_handler_set_rhythm(const rhythm_voice_t *voices, uint8_t voice_count)
+{
+    // Build to the timeline the ISR is not using, only one change can wait at a time
+    portENTER_CRITICAL(&output_context.lock);
+    bool busy = (output_context.pending_timeline != NULL);
+    rhythm_timeline_t *timeline = (output_context.timeline == &output_context.timelines[0]) ? &output_context.timelines[1] : &output_context.timelines[0];
+    portEXIT_CRITICAL(&output_context.lock);
+    if (busy)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = rhythm_timeline_build(timeline, voices, voice_count);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    // Hand the timeline to the ISR, it switches on the next beat
+    portENTER_CRITICAL(&output_context.lock);
+    output_context.pending_timeline = timeline;
+    portEXIT_CRITICAL(&output_context.lock);
+    return ESP_OK;
+}
+
+esp_err_t output_handler_sync(uint64_t beat_time, uint64_t period_num, uint32_t period_den)
+{
+    if (period_num == 0 || period_den == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The external clock overrides the automation and the queued tempo changes
+    portENTER_CRITICAL(&output_context.lock);
+    output_context.automation_state = AUTOMATION_IDLE;
+    output_context.tempo_command_count = 0;
+    beat_scheduler_rephase(&output_context.scheduler, output_context.scheduler.beat, beat_time, period_num, period_den);
+    esp_err_t ret = reschedule_pending(&output_context, period_num, period_den);
+    portEXIT_CRITICAL(&output_context.lock);
+    return ret;
+}
+
+uint64_t output_handler_get_time(void)
+{
+    uint64_t now = 0;
+    gptimer_get_raw_count(output_context.beat_timer, &now);
+    return now;
+}
+
+void output_handler_set_midi_clock(bool running)
+{
+    portENTER_CRITICAL(&output_context.lock);
+    if (running && output_context.midi_clock_state == MIDI_CLOCK_STOPPED)
+    {
+        output_context.midi_clock_state = MIDI_CLOCK_STARTING;
+    }
+    else if (!running && output_context.midi_clock_state == MIDI_CLOCK_RUNNING)
+    {
+        // Stop and tell the receivers where the song stopped
+        static const uint8_t stop = MIDI_STOP;
+        midi_clock_send(&stop, 1);
+        midi_clock_send_song_position(output_context.clock_count / MIDI_CLOCK_PER_POSITION);
+        output_context.clock_time = UINT64_MAX;
+        set_next_alarm(&output_context);
+    }
+    if (!running)
+    {
+        output_context.midi_clock_state = MIDI_CLOCK_STOPPED;
+    }
+    portEXIT_CRITICAL(&output_context.lock);
+}
+
+esp_err_t output_handler_set_swing(uint8_t swing)
+{
+    if (swing < SWING_STRAIGHT || swing > SWING_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The pending event moves with the new swing, the beats keep their timestamps
+    portENTER_CRITICAL(&output_context.lock);
+    beat_scheduler_set_swing(&output_context.scheduler, swing);
+    esp_err_t ret = reschedule_pending(&output_context, output_context.scheduler.period_num, output_context.scheduler.period_den);
+    portEXIT_CRITICAL(&output_context.lock);
+    return ret;
+}
+
+esp_err_t output_handler_set_overrun_policy(output_overrun_policy_t policy)
+{
+    if (policy > OUTPUT_OVERRUN_COALESCE)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&output_context.lock);
+    output_context.overrun_policy = policy;
+    portEXIT_CRITICAL(&output_context.lock);
+    return ESP_OK;
+}
+
+void output_handler_get_overrun_counters(output_overrun_counters_t *counters)
+{
+    portENTER_CRITICAL(&output_context.lock);
+    *counters = output_context.overrun_counters;
+    portEXIT_CRITICAL(&output_context.lock);
+    counters->dropped_beats = atomic_load(&output_context.dropped_beats);
+}
+
+uint64_t output_handler_get_beat_index(void)
+{
+    portENTER_CRITICAL(&output_context.lock);
+    uint64_t beat = output_context.scheduler.beat;
+    portEXIT_CRITICAL(&output_context.lock);
+    return beat;
 }
 
 void output_handler_task(void *arg)
@@ -60,37 +703,51 @@ void output_handler_task(void *arg)
     ESP_LOGI(TAG, "Output handler task initiated.");
 
     // Unpack the necessary parameters
-    QueueHandle_t output_activation_queue = (QueueHandle_t)arg; // Encoder tick queue
+    output_context_t *context = (output_context_t *)arg;
 
-    // Track the current beat count
-    bool signal;
+    // Index of the beat expected next, used to notice lost beats
+    uint64_t expected_beat = 0;
+    uint64_t dequeue_time;
 
     while (1)
     {
-        // Wait for output activation flag to be activated
-        if (xQueueReceive(output_activation_queue, &signal, portMAX_DELAY))
+        // Wait for the beat ISR, several beats may be waiting if the task was held up
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        gptimer_get_raw_count(context->beat_timer, &dequeue_time);
+
+        uint32_t head = atomic_load_explicit(&context->beat_ring_head, memory_order_acquire);
+        uint32_t tail = atomic_load_explicit(&context->beat_ring_tail, memory_order_relaxed);
+        while (tail != head)
         {
-            // Turn off everything if system is a sleep
-            if (get_system_state() == SYSTEM_OFF)
+            beat_event_t beat = context->beat_ring[tail % BEAT_RING_SIZE];
+            atomic_store_explicit(&context->beat_ring_tail, ++tail, memory_order_release);
+
+            // Report beats that did not reach the task
+            if (beat.beat > expected_beat)
             {
-                gpio_set_level(OUTPUT_PIN, false);
-                gpio_set_level(LED_PIN, false);
+                ESP_LOGW(TAG, "%" PRIu64 " beats lost before beat %" PRIu64 ", %" PRIu32 " dropped in total.",
+                         beat.beat - expected_beat, beat.beat, atomic_load(&context->dropped_beats));
             }
-            else
+            expected_beat = beat.beat + 1;
+
+            // Stamp the dequeue time and dump the statistics periodically
+            beat_timing_record_dequeue(beat.sequence, dequeue_time);
+            if (BEAT_TIMING_LOG_INTERVAL > 0 && (beat.sequence + 1) % BEAT_TIMING_LOG_INTERVAL == 0)
             {
-                // Activate and deactivate the output after predermined duration
-                if (get_beat() == 1)
-                {
-                    click(true, true);
-                }
-                else
-                {
-                    click(false, false);
-                }
-                increment_beat();
+                beat_timing_log_dump();
+                output_overrun_counters_t counters;
+                output_handler_get_overrun_counters(&counters);
+                ESP_LOGI(TAG, "Overruns %" PRIu32 ": shortened %" PRIu32 " dropped %" PRIu32 " coalesced %" PRIu32 " late %" PRIu32 " lost beats %" PRIu32,
+                         counters.overruns, counters.shortened, counters.dropped, counters.coalesced, counters.late_events, counters.dropped_beats);
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(10)); // Adjust the delay as needed
+
+        // Turn off everything if system is a sleep
+        if (get_system_state() == SYSTEM_OFF)
+        {
+            gpio_set_level(OUTPUT_PIN, false);
+            gpio_set_level(LED_PIN, false);
+        }
     }
 }
 
@@ -100,25 +757,13 @@ esp_err_t start_output_handler(void)
     static const char *TAG = "start_output_handler";
     ESP_LOGI(TAG, "Output handler setup started.");
 
-    // Create encoder action queue
-    static QueueHandle_t output_activation_queue = NULL;
-    output_activation_queue = xQueueCreate(10, sizeof(bool));
-
-    // Check that queue creation succeeded
-    if (output_activation_queue == NULL)
-    {
-        ESP_LOGE(TAG, "Encoder action queue creation failed.");
-        return ESP_FAIL;
-    }
-
     /* Set the GPIO as a push/pull output */
     gpio_reset_pin(OUTPUT_PIN);
     gpio_set_direction(OUTPUT_PIN, GPIO_MODE_OUTPUT);
     gpio_reset_pin(LED_PIN);
     gpio_set_direction(LED_PIN, GPIO_MODE_OUTPUT);
 
-    // Create timer handle
-    gptimer_handle_t gptimer = NULL;
+    // Timer configuration shared by the beat and the pulse timer
     gptimer_config_t timer_config = {
         .clk_src = GPTIMER_CLK_SRC_DEFAULT,
         .direction = GPTIMER_COUNT_UP,
@@ -126,56 +771,147 @@ esp_err_t start_output_handler(void)
         .intr_priority = 1,
     };
 
-    // Create timer, return error if not succesful
+    // Create timers, return error if not succesful
     esp_err_t ret;
-    ret = gptimer_new_timer(&timer_config, &gptimer);
+    ret = gptimer_new_timer(&timer_config, &output_context.beat_timer);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Output timer creation failed.");
         return ret;
     }
+    ret = gptimer_new_timer(&timer_config, &output_context.pulse_timer);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Pulse timer creation failed.");
+        return ret;
+    }
 
-    // Set callback for the timer, return error if not succesful
+    // Set callbacks for the timers, return error if not succesful
     gptimer_event_callbacks_t cbs = {
         .on_alarm = output_timer_alarm,
     };
-    ret = gptimer_register_event_callbacks(gptimer, &cbs, (void *)output_activation_queue);
+    ret = gptimer_register_event_callbacks(output_context.beat_timer, &cbs, (void *)&output_context);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Output timer callback registration failed.");
         return ret;
     }
+    gptimer_event_callbacks_t pulse_cbs = {
+        .on_alarm = pulse_timer_alarm,
+    };
+    ret = gptimer_register_event_callbacks(output_context.pulse_timer, &pulse_cbs, (void *)&output_context);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Pulse timer callback registration failed.");
+        return ret;
+    }
+
+    // Enable and start the free running pulse timer, alarms are set per click
+    ret = gptimer_enable(output_context.pulse_timer);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Pulse timer enable failed.");
+        return ret;
+    }
+    ret = gptimer_start(output_context.pulse_timer);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Pulse timer start failed.");
+        return ret;
+    }
+
+    // Setup task parameters and start the task before the first beat can notify it
+    BaseType_t x_returned;
+    x_returned = xTaskCreate(output_handler_task, "output_handler_task", 3072, (void *)&output_context, 10, &output_context.task);
+    if (x_returned != pdPASS)
+    {
+        ESP_LOGE(TAG, "Output handler task creation failed.");
+        return ESP_FAIL;
+    }
+
+    // Setup the MIDI clock output, it starts on the first downbeat
+    if (MIDI_CLOCK_ENABLED)
+    {
+        ret = midi_clock_init();
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "MIDI clock setup failed.");
+            return ret;
+        }
+        output_context.midi_clock_state = MIDI_CLOCK_STARTING;
+    }
 
     // Enable, set first alarm and start the timer.
-    ret = gptimer_enable(gptimer);
+    ret = gptimer_enable(output_context.beat_timer);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Output timer enable failed.");
         return ret;
     }
-    gptimer_alarm_config_t alarm_config = {
-        .alarm_count = 1000000, // period = 1s
-    };
-    ret = gptimer_set_alarm_action(gptimer, &alarm_config);
+    beat_scheduler_init(&output_context.scheduler, 1000000, get_selected_bpm()); // first beat at 1s
+    rhythm_timeline_build(&output_context.timelines[0], NULL, 0);                // main beat only
+    output_context.timeline = &output_context.timelines[0];
+    output_context.event = 0;
+    output_context.event_time = output_context.scheduler.time;
+    output_context.clock_time = UINT64_MAX;
+    output_context.automation = &output_context.automations[0];
+    ret = set_next_alarm(&output_context);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Output timer set alarm failed.");
         return ret;
     }
-    ret = gptimer_start(gptimer);
+    ret = gptimer_start(output_context.beat_timer);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Output timer start failed.");
         return ret;
     }
 
-    // Setup task parameters and start the task
-    BaseType_t x_returned;
-    x_returned = xTaskCreate(output_handler_task, "output_handler_task", 2048, (void *)output_activation_queue, 10, NULL);
-    if (x_returned != pdPASS)
+    // Apply the swing of the settings, out of range values are reported instead of clamped
+    ret = output_handler_set_swing(SWING_PERCENT);
+    if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "Output handler task creation failed.");
-        return ESP_FAIL;
+        ESP_LOGE(TAG, "Swing setup failed.");
+        return ret;
+    }
+
+    // Add the subdivision and polyrhythm voices of the settings on top of the main beat
+    rhythm_voice_t voices[2];
+    uint8_t voice_count = 0;
+    if (SUBDIVISION > 1)
+    {
+        voices[voice_count++] = (rhythm_voice_t){.pulses = SUBDIVISION, .beats = 1};
+    }
+    if (POLYRHYTHM_PULSES > 0)
+    {
+        voices[voice_count++] = (rhythm_voice_t){.pulses = POLYRHYTHM_PULSES, .beats = POLYRHYTHM_BEATS};
+    }
+    if (voice_count > 0)
+    {
+        ret = output_handler_set_rhythm(voices, voice_count);
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Rhythm setup failed.");
+            return ret;
+        }
+    }
+
+    // Run the speed trainer from the start tempo, it begins on the first downbeat
+    if (TEMPO_TRAINER_ENABLED)
+    {
+        static tempo_automation_t trainer; // Too large for the stack of the calling task
+        tempo_automation_init(&trainer);
+        ret = tempo_automation_add_steps(&trainer, get_selected_bpm(), TEMPO_TRAINER_STEP, TEMPO_TRAINER_STEP_BEATS, TEMPO_TRAINER_CEILING);
+        if (ret == ESP_OK)
+        {
+            ret = output_handler_start_automation(&trainer);
+        }
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Speed trainer start failed.");
+            return ret;
+        }
     }
 
     ESP_LOGI(TAG, "Output driver setup finished.");
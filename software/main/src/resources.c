@@ -1,6 +1,5 @@
 #include "resources.h"
 
-uint16_t signature_modes[SIGNATURE_IMAGES] = {4, 3, 2};
 uint8_t segment_display_signatures[SIGNATURE_IMAGES][192] = {
     {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
      //.... 'seven-segment-display-gray-0', 32x48px
@@ -104,113 +103,145 @@ uint8_t segment_display_signatures[SIGNATURE_IMAGES][192] = {
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00},
-};
-
-uint8_t segment_display_signatures_inverse[SIGNATURE_IMAGES][192] = {
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
+    {//.... 5/4 time signature, digits drawn in the style of the seven segment glyphs
+     //.... 'signature-5-4', 32x48px
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
+     0x03, 0xff, 0xc0, 0x00, //......XXXXXXXXXXXX..............
+     0x03, 0xff, 0xc0, 0x00, //......XXXXXXXXXXXX..............
+     0x03, 0xc0, 0x00, 0x00, //......XXXX......................
+     0x03, 0xc0, 0x00, 0x00, //......XXXX......................
+     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
+     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xff, 0x00, //..............XXXXXXXXXX........
-     0x00, 0x03, 0xff, 0x00, //..............XXXXXXXXXX........
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0xc0, 0x00, //........XXXXXXXXXX..............
+     0x00, 0xff, 0xc0, 0x00, //........XXXXXXXXXX..............
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xff, 0x00, //..............XXXXXXXXXX........
-     0x00, 0x03, 0xff, 0x00, //..............XXXXXXXXXX........
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
+    {//.... 6/8 time signature, digits drawn in the style of the seven segment glyphs
+     //.... 'signature-6-8', 32x48px
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xff, 0x00, //..............XXXXXXXXXX........
-     0x00, 0x03, 0xff, 0x00, //..............XXXXXXXXXX........
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x03, 0xc0, 0x00, 0x00, //......XXXX......................
+     0x03, 0xc0, 0x00, 0x00, //......XXXX......................
+     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
+     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
-     0x00, 0x00, 0xff, 0x00, //................XXXXXXXX........
-     0x00, 0x00, 0xff, 0x00, //................XXXXXXXX........
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x00, 0xfc, 0x00, //................XXXXXX..........
-     0x00, 0x00, 0xfc, 0x00, //................XXXXXX..........
-     0x00, 0x03, 0xc0, 0xc0, //..............XXXX......XX......
-     0x00, 0x03, 0xc0, 0xc0, //..............XXXX......XX......
-     0x00, 0x00, 0xff, 0x00, //................XXXXXXXX........
-     0x00, 0x00, 0xff, 0x00, //................XXXXXXXX........
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
+    {//.... 7/8 time signature, digits drawn in the style of the seven segment glyphs
+     //.... 'signature-7-8', 32x48px
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
+     0x03, 0xff, 0xc0, 0x00, //......XXXXXXXXXXXX..............
+     0x03, 0xff, 0xc0, 0x00, //......XXXXXXXXXXXX..............
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
      0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xff, 0x00, //..............XXXXXXXXXX........
-     0x00, 0x03, 0xff, 0x00, //..............XXXXXXXXXX........
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
+     0x00, 0x0f, 0x00, 0x00, //............XXXX................
+     0x00, 0x0f, 0x00, 0x00, //............XXXX................
+     0x00, 0x3c, 0x00, 0x00, //..........XXXX..................
+     0x00, 0x3c, 0x00, 0x00, //..........XXXX..................
+     0x00, 0x3c, 0x00, 0x00, //..........XXXX..................
+     0x00, 0x3c, 0x00, 0x00, //..........XXXX..................
+     0x00, 0x3c, 0x00, 0x00, //..........XXXX..................
+     0x00, 0x3c, 0x00, 0x00, //..........XXXX..................
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00,
-     0x00, 0x03, 0xff, 0xc0, //..............XXXXXXXXXXXX......
-     0x00, 0x03, 0xff, 0xc0, //..............XXXXXXXXXXXX......
-     0x00, 0x00, 0x0f, 0x00, //....................XXXX........
-     0x00, 0x00, 0x0f, 0x00, //....................XXXX........
-     0x00, 0x00, 0xfc, 0x00, //................XXXXXX..........
-     0x00, 0x00, 0xfc, 0x00, //................XXXXXX..........
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc0, 0x00, //..............XXXX..............
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x03, 0xc3, 0xc0, //..............XXXX....XXXX......
-     0x00, 0x00, 0xff, 0x00, //................XXXXXXXX........
-     0x00, 0x00, 0xff, 0x00, //................XXXXXXXX........
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00},
+    {//.... 12/8 time signature, digits drawn in the style of the seven segment glyphs
+     //.... 'signature-12-8', 32x48px
+     0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00,
+     0x1e, 0x07, 0xf8, 0x00, //...XXXX......XXXXXXXX...........
+     0x1e, 0x07, 0xf8, 0x00, //...XXXX......XXXXXXXX...........
+     0x7e, 0x1e, 0x1e, 0x00, //.XXXXXX....XXXX....XXXX.........
+     0x7e, 0x1e, 0x1e, 0x00, //.XXXXXX....XXXX....XXXX.........
+     0x1e, 0x00, 0x1e, 0x00, //...XXXX............XXXX.........
+     0x1e, 0x00, 0x1e, 0x00, //...XXXX............XXXX.........
+     0x1e, 0x01, 0xf8, 0x00, //...XXXX........XXXXXX...........
+     0x1e, 0x01, 0xf8, 0x00, //...XXXX........XXXXXX...........
+     0x1e, 0x07, 0x80, 0x00, //...XXXX......XXXX...............
+     0x1e, 0x07, 0x80, 0x00, //...XXXX......XXXX...............
+     0x7f, 0x9f, 0xfe, 0x00, //.XXXXXXXX..XXXXXXXXXXXX.........
+     0x7f, 0x9f, 0xfe, 0x00, //.XXXXXXXX..XXXXXXXXXXXX.........
+     0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00,
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x03, 0xc3, 0xc0, 0x00, //......XXXX....XXXX..............
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
+     0x00, 0xff, 0x00, 0x00, //........XXXXXXXX................
      0x00, 0x00, 0x00, 0x00,
      0x00, 0x00, 0x00, 0x00},
 };
 
+
 uint8_t segment_display_numbers[NUMBER_IMAGES][192] = {
     {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
      //.... 'seven-segment-display-gray-0', 32x48px
@@ -554,348 +585,6 @@ uint8_t segment_display_numbers[NUMBER_IMAGES][192] = {
      0x00, 0x00, 0x00, 0x00},
 };
 
-uint8_t segment_display_numbers_inverse[NUMBER_IMAGES][192] = {
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xff, 0x00, //...........XXXXXXXXXXXXXXX......
-     0x00, 0x1f, 0xff, 0x00, //...........XXXXXXXXXXXXXXX......
-     0x00, 0x1f, 0xff, 0x00, //...........XXXXXXXXXXXXXXX......
-     0x00, 0x1f, 0xff, 0x00, //...........XXXXXXXXXXXXXXX......
-     0x00, 0x1f, 0xff, 0x00, //...........XXXXXXXXXXXXXXX......
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x00, 0x00, 0xff, 0xc0, //................XXXXXXXXXX......
-     0x00, 0x00, 0xff, 0xc0, //................XXXXXXXXXX......
-     0x00, 0x00, 0xff, 0xc0, //................XXXXXXXXXX......
-     0x00, 0x00, 0xff, 0xc0, //................XXXXXXXXXX......
-     0x00, 0x00, 0xff, 0xc0, //................XXXXXXXXXX......
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x03, 0xff, 0xf8, 0x00, //......XXXXXXXXXXXXXXX...........
-     0x7f, 0xe0, 0x00, 0x3e, //.XXXXXXXXXX...............XXXXX.
-     0x7f, 0xe0, 0x00, 0x3e, //.XXXXXXXXXX...............XXXXX.
-     0x7f, 0xe0, 0x00, 0x3e, //.XXXXXXXXXX...............XXXXX.
-     0x7f, 0xe0, 0x00, 0x3e, //.XXXXXXXXXX...............XXXXX.
-     0x7f, 0xe0, 0x00, 0x3e, //.XXXXXXXXXX...............XXXXX.
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xfe, //......XXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x00, 0x00, 0x07, 0xfe, //.....................XXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x00, 0x1f, 0xf8, 0x00, //...........XXXXXXXXXX...........
-     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
-     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
-     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
-     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
-     0x03, 0xff, 0x00, 0x00, //......XXXXXXXXXX................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x7f, 0xff, 0xff, 0xfe, //.XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX.
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x00, 0x00, 0x00, 0x00},
-    {//.... https://....www.iconspng.com/image/5656/seven-segment-display-gray-0
-     //.... 'seven-segment-display-gray-0', 32x48px
-     0x00, 0x00, 0x00, 0x00,
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xe0, 0x00, 0x00, //.XXXXXXXXXX.....................
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xff, 0xff, 0xc0, //.XXXXXXXXXXXXXXXXXXXXXXXXX......
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x7f, 0xe0, 0x07, 0xfe, //.XXXXXXXXXX..........XXXXXXXXXX.
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x03, 0xff, 0xff, 0xc0, //......XXXXXXXXXXXXXXXXXXXX......
-     0x00, 0x00, 0x00, 0x00},
-};
 
 uint8_t segment_display_standby[STANDBY_IMAGES][192] = {
     {
@@ -1005,114 +694,4 @@ uint8_t segment_display_standby[STANDBY_IMAGES][192] = {
         0x00, 0x00, 0x00, 0x00, //................................
         0x00, 0x00, 0x00, 0x00, //................................//
     },
-};
-
-uint8_t segment_display_standby_inverse[STANDBY_IMAGES][192] = {
-    {
-        0xFF, 0x1F, 0xFF, 0xFF, // XXXXXXXX...XXXXXXXXXXXXXXXXXXXXX
-        0xFF, 0x1F, 0xFF, 0xFF, // XXXXXXXX...XXXXXXXXXXXXXXXXXXXXX
-        0xFF, 0x1F, 0xFF, 0xFF, // XXXXXXXX...XXXXXXXXXXXXXXXXXXXXX
-        0xF8, 0x1F, 0x81, 0xF8, // XXXXX......XXXXXX......XXXXXX...
-        0xF8, 0x1F, 0x81, 0xF8, // XXXXX......XXXXXX......XXXXXX...
-        0xF8, 0x1F, 0x81, 0xF8, // XXXXX......XXXXXX......XXXXXX...
-        0xC0, 0x1C, 0x0F, 0xC0, // XX.........XXX......XXXXXX......
-        0xC0, 0x1C, 0x0F, 0xC0, // XX.........XXX......XXXXXX......
-        0xC0, 0x1C, 0x0F, 0xC0, // XX.........XXX......XXXXXX......
-        0x07, 0x00, 0x7E, 0x00, //.....XXX.........XXXXXX.........
-        0x07, 0x00, 0x7E, 0x00, //.....XXX.........XXXXXX.........
-        0x07, 0x00, 0x7E, 0x00, //.....XXX.........XXXXXX.........
-        0xFF, 0x03, 0xF0, 0x07, // XXXXXXXX......XXXXXX.........XXX
-        0xFF, 0x03, 0xF0, 0x07, // XXXXXXXX......XXXXXX.........XXX
-        0xFF, 0x03, 0xF0, 0x07, // XXXXXXXX......XXXXXX.........XXX
-        0x00, 0x1F, 0x80, 0x3F, //............XXXXXX.........XXXXXX
-        0x00, 0x1F, 0x80, 0x3F, //............XXXXXX.........XXXXXX
-        0x00, 0x1F, 0x80, 0x3F, //............XXXXXX.........XXXXXX
-        0x00, 0x1F, 0xFF, 0xFF, //............XXXXXXXXXXXXXXXXXXXXX
-        0x00, 0x1F, 0xFF, 0xFF, //............XXXXXXXXXXXXXXXXXXXXX
-        0x00, 0x1F, 0xFF, 0xFF, //............XXXXXXXXXXXXXXXXXXXXX
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00  //.................................
-    },
-    {
-        //
-        0xFF, 0xFF, 0x03, 0xFF, // XXXXXXXXXXXXXXXX......XXXXXXXXXX
-        0xFF, 0xFF, 0x03, 0xFF, // XXXXXXXXXXXXXXXX......XXXXXXXXXX
-        0xFF, 0xFF, 0x03, 0xFF, // XXXXXXXXXXXXXXXX......XXXXXXXXXX
-        0x81, 0xF8, 0x03, 0x81, // X......XXXXXX.........XXX......X
-        0x81, 0xF8, 0x03, 0x81, // X......XXXXXX.........XXX......X
-        0x81, 0xF8, 0x03, 0x81, // X......XXXXXX.........XXX......X
-        0x0F, 0xC0, 0x00, 0x0F, //....XXXXXX...................XXXX
-        0x0F, 0xC0, 0x00, 0x0F, //....XXXXXX...................XXXX
-        0x0F, 0xC0, 0x00, 0x0F, //....XXXXXX...................XXXX
-        0x70, 0x07, 0x00, 0x70, //.XXX.........XXX..........XXX....
-        0x70, 0x07, 0x00, 0x70, //.XXX.........XXX..........XXX....
-        0x70, 0x07, 0x00, 0x70, //.XXX.........XXX..........XXX....
-        0xFF, 0xFF, 0x03, 0xFF, // XXXXXXXXXXXXXXXX......XXXXXXXXXX
-        0xFF, 0xFF, 0x03, 0xFF, // XXXXXXXXXXXXXXXX......XXXXXXXXXX
-        0xFF, 0xFF, 0x03, 0xFF, // XXXXXXXXXXXXXXXX......XXXXXXXXXX
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00, //.................................
-        0x00, 0x00, 0x00, 0x00  //.................................
-    },
-    {
-        //
-        0x00, 0x70, 0x00, 0x03, //.........XXX..................XX
-        0x00, 0x70, 0x00, 0x03, //.........XXX..................XX
-        0x00, 0x70, 0x00, 0x03, //.........XXX..................XX
-        0x00, 0x00, 0x00, 0x03, //..............................XX
-        0x00, 0x00, 0x00, 0x03, //..............................XX
-        0x00, 0x00, 0x00, 0x03, //..............................XX
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x03, //..............................XX
-        0x00, 0x00, 0x00, 0x03, //..............................XX
-        0x00, 0x00, 0x00, 0x03, //..............................XX
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00  //................................
-    },
-    {
-        //
-        0x07, 0x00, 0x01, 0xC0, //.....XXX...............XXX......
-        0x07, 0x00, 0x01, 0xC0, //.....XXX...............XXX......
-        0x07, 0x00, 0x01, 0xC0, //.....XXX...............XXX......
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................
-        0x00, 0x00, 0x00, 0x00, //................................//
-    },
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "rhythm_timeline.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Greatest common divisor
+ *
+ * @param uint32_t a First value.
+ * @param uint32_t b Second value.
+ * @return uint32_t greatest common divisor.
+ */
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0)
+    {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * Least common multiple
+ *
+ * @param uint32_t a First value.
+ * @param uint32_t b Second value.
+ * @return uint32_t least common multiple.
+ */
+static uint32_t lcm(uint32_t a, uint32_t b)
+{
+    return a / gcd(a, b) * b;
+}
+
+esp_err_t rhythm_timeline_build(rhythm_timeline_t *timeline, const rhythm_voice_t *voices, uint8_t voice_count)
+{
+    if (voice_count > RHYTHM_MAX_VOICES || (voice_count > 0 && voices == NULL))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Find a grid that places every pulse exactly and the cycle after which all voices line up again
+    uint32_t ticks_per_beat = 1;
+    uint32_t cycle_beats = 1;
+    for (int i = 0; i < voice_count; i++)
+    {
+        if (voices[i].pulses == 0 || voices[i].beats == 0)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        ticks_per_beat = lcm(ticks_per_beat, voices[i].pulses / gcd(voices[i].pulses, voices[i].beats));
+        cycle_beats = lcm(cycle_beats, voices[i].beats);
+        if (ticks_per_beat > RHYTHM_MAX_TICKS || cycle_beats > RHYTHM_MAX_CYCLE_BEATS)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // Pulse counts and grid spacing of the main beat and the voices
+    uint32_t pulse_count[RHYTHM_MAX_VOICES + 1] = {cycle_beats};
+    uint32_t pulse_spacing[RHYTHM_MAX_VOICES + 1] = {ticks_per_beat};
+    uint32_t next_pulse[RHYTHM_MAX_VOICES + 1] = {0};
+    for (int i = 0; i < voice_count; i++)
+    {
+        pulse_count[i + 1] = voices[i].pulses * (cycle_beats / voices[i].beats);
+        pulse_spacing[i + 1] = voices[i].beats * ticks_per_beat / voices[i].pulses;
+    }
+
+    // Merge the voices by always taking the earliest pending pulse, equal positions become one event
+    timeline->event_count = 0;
+    timeline->ticks_per_beat = ticks_per_beat;
+    timeline->cycle_beats = cycle_beats;
+    while (true)
+    {
+        uint32_t position = UINT32_MAX;
+        for (int voice = 0; voice <= voice_count; voice++)
+        {
+            if (next_pulse[voice] < pulse_count[voice] && next_pulse[voice] * pulse_spacing[voice] < position)
+            {
+                position = next_pulse[voice] * pulse_spacing[voice];
+            }
+        }
+        if (position == UINT32_MAX)
+        {
+            break;
+        }
+        if (timeline->event_count >= RHYTHM_MAX_EVENTS)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+
+        rhythm_event_t *event = &timeline->events[timeline->event_count++];
+        event->beat = position / ticks_per_beat;
+        event->tick = position % ticks_per_beat;
+        event->voices = 0;
+        for (int voice = 0; voice <= voice_count; voice++)
+        {
+            if (next_pulse[voice] < pulse_count[voice] && next_pulse[voice] * pulse_spacing[voice] == position)
+            {
+                event->voices |= 1 << voice;
+                next_pulse[voice]++;
+            }
+        }
+    }
+    return ESP_OK;
+}
\ No newline at end of file
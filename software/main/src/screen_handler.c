@@ -2,51 +2,193 @@
 
 #include "ssd1306.h"
 #include "settings.h"
-#include "resources.h"
+#include "glyph_store.h"
 #include "shared_variables.h"
+#include "meter_patterns.h"
 #include "screen_handler.h"
+#include "screen_panel.h"
 
 #include "esp_log.h"
 #include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+
+// Notification bit of a rotation request, next to the STATE_CHANGE_* bits
+#define SCREEN_CHANGE_ROTATION (1UL << 31)
 
-static uint8_t *segment_image_numbers = NULL;
-static uint8_t *segment_image_signatures = NULL;
-// static uint8_t *segment_image_standby = NULL;
 static SSD1306_t dev;
+static TaskHandle_t screen_task = NULL;
+static _Atomic bool screen_rotated = INVERT_SCREEN;
+_Static_assert(GLYPH_PAGES == SCREEN_PAGES, "Glyphs must cover the panel height");
+
+// Frame being composed and the shadow of what the panel shows, the panel is cleared at start
+static uint8_t frame[SCREEN_PAGES][SCREEN_COLUMNS];
+static uint8_t shadow[SCREEN_PAGES][SCREEN_COLUMNS];
+static bool shadow_valid = true;
+static screen_stats_t screen_stats = {0};
 
-void get_indexes(uint16_t *arr)
+void get_indexes(const state_snapshot_t *snapshot, uint16_t *arr)
 {
-    uint16_t bpm = get_candidate_bpm();
-    arr[0] = get_signature_mode() * 256; // Signature mode * 256
-    arr[1] = bpm / 100 * 256;            // Hundreds in bpm * 256
-    arr[2] = (bpm / 10) % 10 * 256;      // Tens in bpm * 256
-    arr[3] = bpm % 10 * 256;             // Ones in bpm * 256
+    uint16_t bpm = snapshot->bpm_candidate;
+    arr[0] = GLYPH_SIGNATURE(get_meter_pattern(snapshot->signature_mode)->glyph); // Signature glyph
+    arr[1] = GLYPH_NUMBER(bpm / 100);                                             // Hundreds in bpm
+    arr[2] = GLYPH_NUMBER((bpm / 10) % 10);                                       // Tens in bpm
+    arr[3] = GLYPH_NUMBER(bpm % 10);                                              // Ones in bpm
 }
 
-bool is_screen_dim()
+/**
+ * @brief Window of the frame sent to the panel, pages and columns inclusive
+ */
+typedef struct
+{
+    uint8_t first_page;
+    uint8_t last_page;
+    uint8_t first_column;
+    uint8_t last_column;
+} screen_window_t;
+
+/**
+ * Send the changes of the frame to the panel and update the shadow. The changed column spans of every page are
+ * sent as windows of their own when that costs less on the bus than one window around all of them, e.g. two
+ * changed digits send only their differing columns instead of everything between them.
+ *
+ * @param void
+ * @return void.
+ */
+static void flush_frame(void)
 {
-    // Initialize frame counter for blinking
-    static uint8_t frame_counter = 0;
-    static bool screen_bright = true;
+    // Find the changed spans and the window around them, everything when the panel content is unknown
+    screen_window_t spans[SCREEN_MAX_SPANS];
+    screen_window_t bounds = {SCREEN_PAGES, 0, SCREEN_COLUMNS, 0};
+    int span_count = 0;
+    uint32_t span_bytes = 0;
+    bool sparse = shadow_valid;
+    for (int page = 0; shadow_valid && page < SCREEN_PAGES; page++)
+    {
+        int column = 0;
+        while (column < SCREEN_COLUMNS)
+        {
+            // Find the start of the next changed span
+            while (column < SCREEN_COLUMNS && frame[page][column] == shadow[page][column])
+            {
+                column++;
+            }
+            if (column == SCREEN_COLUMNS)
+            {
+                break;
+            }
+
+            // Extend the span until the content matches for longer than the merge gap
+            int start = column;
+            int end = column + 1;
+            for (column = end; column < SCREEN_COLUMNS && column - end <= SCREEN_SPAN_MERGE_GAP; column++)
+            {
+                if (frame[page][column] != shadow[page][column])
+                {
+                    end = column + 1;
+                }
+            }
+            column = end;
+
+            bounds.first_page = (page < bounds.first_page) ? page : bounds.first_page;
+            bounds.last_page = page;
+            bounds.first_column = (start < bounds.first_column) ? start : bounds.first_column;
+            bounds.last_column = (end - 1 > bounds.last_column) ? end - 1 : bounds.last_column;
+            span_bytes += end - start;
+            if (span_count < SCREEN_MAX_SPANS)
+            {
+                spans[span_count] = (screen_window_t){page, page, start, end - 1};
+            }
+            span_count++;
+        }
+    }
+    if (!shadow_valid)
+    {
+        bounds = (screen_window_t){0, SCREEN_PAGES - 1, 0, SCREEN_COLUMNS - 1};
+    }
+    else if (span_count == 0)
+    {
+        return;
+    }
 
-    // If BPM value and selected BPM value are the same, screen bright
-    if (bpm_selcted())
+    // Fall back to the single window when the spans are too many or cost more than it
+    uint32_t window_bytes = (bounds.last_page - bounds.first_page + 1) * (bounds.last_column - bounds.first_column + 1);
+    if (!sparse || span_count > SCREEN_MAX_SPANS || span_bytes + span_count * SCREEN_WINDOW_COST >= window_bytes + SCREEN_WINDOW_COST)
     {
-        frame_counter = 0;
-        screen_bright = true;
-        return false;
+        spans[0] = bounds;
+        span_count = 1;
     }
 
-    // If blinking is on, count the frames for blinking purposes
-    frame_counter++;
+    // Every window takes a command and a data transaction, the shadow and the counters are only updated once the
+    // panel has the data
+    uint32_t frame_bytes = 0;
+    uint32_t frame_transactions = 0;
+    bool complete = true;
+    for (int span = 0; span < span_count; span++)
+    {
+        const screen_window_t *window = &spans[span];
+        if (screen_panel_write_window(&dev, &frame[0][0], SCREEN_COLUMNS, window->first_page, window->last_page,
+                                      window->first_column, window->last_column) != ESP_OK)
+        {
+            complete = false;
+            break;
+        }
+        for (int page = window->first_page; page <= window->last_page; page++)
+        {
+            memcpy(&shadow[page][window->first_column], &frame[page][window->first_column], window->last_column - window->first_column + 1);
+        }
+        frame_bytes += (window->last_page - window->first_page + 1) * (window->last_column - window->first_column + 1);
+        frame_transactions += 2;
+    }
 
-    // Determine if screen should be on or off based on frames (4 in each mode)
-    if (frame_counter > 4)
+    screen_stats.bytes += frame_bytes;
+    screen_stats.transactions += frame_transactions;
+    screen_stats.last_frame_bytes = frame_bytes;
+    screen_stats.last_frame_transactions = frame_transactions;
+    if (!complete)
     {
-        screen_bright = !screen_bright;
-        frame_counter = 0;
+        screen_stats.failed++;
+        return;
     }
-    return screen_bright;
+    screen_stats.frames++;
+    shadow_valid = true;
+}
+
+/**
+ * Compose the signature and the candidate bpm to the frame
+ *
+ * @param const state_snapshot_t* snapshot State to draw.
+ * @return void.
+ */
+static void compose_state(const state_snapshot_t *snapshot)
+{
+    // Glyphs are copied in the original drawing order, the overlapping columns come from the later glyph
+    static const uint8_t columns[4] = {0, 26, 61, 96};
+    uint16_t index_array[4];
+    get_indexes(snapshot, index_array);
+    memset(frame, 0, sizeof(frame));
+    for (int glyph = 0; glyph < 4; glyph++)
+    {
+        const uint8_t *image = glyph_store_get(index_array[glyph]);
+        for (int page = 0; page < SCREEN_PAGES; page++)
+        {
+            memcpy(&frame[page][columns[glyph]], &image[page * GLYPH_COLUMNS], GLYPH_COLUMNS);
+        }
+    }
+}
+
+void screen_handler_set_rotation(bool rotated)
+{
+    atomic_store(&screen_rotated, rotated);
+    if (screen_task != NULL)
+    {
+        xTaskNotify(screen_task, SCREEN_CHANGE_ROTATION, eSetBits);
+    }
+}
+
+void screen_handler_get_stats(screen_stats_t *stats)
+{
+    *stats = screen_stats;
 }
 
 void screen_update_handler_task(void *arg)
@@ -55,107 +197,84 @@ void screen_update_handler_task(void *arg)
     static const char *TAG = "screen_update_handler_task";
     ESP_LOGI(TAG, "Screen update handler task initiated.");
 
-    // Initialize necesary parameters
-    TickType_t x_last_wake_time;                      // Time when screen was updated
-    const TickType_t x_frequency = pdMS_TO_TICKS(42); // 1000ms = 1 second
-    // bool clear_screen = false;                        // Screen on/off during blinking
+    // Only the shown variables wake the task, the beat counter changes on every beat
+    subscribe_state_changes(xTaskGetCurrentTaskHandle(), STATE_CHANGE_ALL & ~STATE_CHANGE_CURRENT_BEAT);
 
-    // Initialize the last wake time
-    x_last_wake_time = xTaskGetTickCount();
+    // Initialize necesary parameters
+    const TickType_t blink_interval = pdMS_TO_TICKS(SCREEN_BLINK_INTERVAL);
+    TickType_t next_blink = 0;
+    bool screen_dim = false;
+    bool was_blinking = false;
+    uint32_t changes = STATE_CHANGE_ALL; // Draw everything on the first pass
     while (true)
     {
-        // System off state, clear the screen, otherwise display BPM and the signature
-        if (get_system_state() == SYSTEM_OFF)
+        // The remap applies to new data only, so the whole picture is written again in the new orientation
+        if (changes & SCREEN_CHANGE_ROTATION)
+        {
+            screen_panel_set_rotation(&dev, atomic_load(&screen_rotated));
+            shadow_valid = false;
+            changes |= STATE_CHANGE_SYSTEM_STATE;
+        }
+
+        state_snapshot_t snapshot;
+        get_state_snapshot(&snapshot);
+        bool blinking = snapshot.system_state == SYSTEM_ON && snapshot.bpm_selected != snapshot.bpm_candidate;
+
+        // System off state, clear the screen once, otherwise redraw only what changed
+        if (snapshot.system_state == SYSTEM_OFF)
         {
-            // Clear the screen
-            ssd1306_clear_screen(&dev, false);
-            // ssd1306_contrast(&dev, 0x00);
-            // for (int page = 0; page < 8; page++)
-            // {
-            //     if (INVERT_SCREEN)
-            //     {
-            //         ssd1306_display_image(&dev, page, 96, &segment_image_standby[0 * 256 + page * 32], 32);
-            //         ssd1306_display_image(&dev, page, 64, &segment_image_standby[1 * 256 + page * 32], 32);
-            //         ssd1306_display_image(&dev, page, 32, &segment_image_standby[2 * 256 + page * 32], 32);
-            //         ssd1306_display_image(&dev, page, 0, &segment_image_standby[3 * 256 + page * 32], 32);
-            //     }
-            //     else
-            //     {
-            //         ssd1306_display_image(&dev, page, 0, &segment_image_standby[0 * 256 + page * 32], 32);
-            //         ssd1306_display_image(&dev, page, 32, &segment_image_standby[1 * 256 + page * 32], 32);
-            //         ssd1306_display_image(&dev, page, 64, &segment_image_standby[2 * 256 + page * 32], 32);
-            //         ssd1306_display_image(&dev, page, 96, &segment_image_standby[3 * 256 + page * 32], 32);
-            //     }
-            // }
-
-            // // Require clear screen after
-            // clear_screen = true;
+            if (changes & STATE_CHANGE_SYSTEM_STATE)
+            {
+                memset(frame, 0, sizeof(frame));
+                flush_frame();
+            }
         }
         else
         {
-            // // Clear the screen if required
-            // if (clear_screen)
-            // {
-            //     ssd1306_clear_screen(&dev, false);
-            //     clear_screen = false;
-            // }
-
-            // Set contrast accordingly
-            ssd1306_contrast(&dev, is_screen_dim() ? 0x00 : 0xFF);
-
-            // Parse necessary informatiion from bpm variable and determine if blinking should be on
-            uint16_t index_array[4];
-            get_indexes(index_array);
-            for (int page = 0; page < 8; page++)
+            if (changes & (STATE_CHANGE_BPM_CANDIDATE | STATE_CHANGE_SIGNATURE_MODE | STATE_CHANGE_SYSTEM_STATE))
             {
-                if (INVERT_SCREEN)
-                {
-                    ssd1306_display_image(&dev, page, 96, &segment_image_signatures[index_array[0] + page * 32], 32);
-                    ssd1306_display_image(&dev, page, 70, &segment_image_numbers[index_array[1] + page * 32], 32);
-                    ssd1306_display_image(&dev, page, 35, &segment_image_numbers[index_array[2] + page * 32], 32);
-                    ssd1306_display_image(&dev, page, 0, &segment_image_numbers[index_array[3] + page * 32], 32);
-                }
-                else
+                compose_state(&snapshot);
+                flush_frame();
+                ESP_LOGD(TAG, "Frame sent, %" PRIu32 " bytes in %" PRIu32 " transactions.", screen_stats.last_frame_bytes, screen_stats.last_frame_transactions);
+            }
+
+            // Blink while the candidate bpm is not selected, starting bright, bright otherwise
+            bool dim = false;
+            TickType_t now = xTaskGetTickCount();
+            if (blinking && !was_blinking)
+            {
+                next_blink = now + blink_interval;
+            }
+            else if (blinking)
+            {
+                dim = screen_dim;
+                if ((int32_t)(next_blink - now) <= 0)
                 {
-                    ssd1306_display_image(&dev, page, 0, &segment_image_signatures[index_array[0] + page * 32], 32);
-                    ssd1306_display_image(&dev, page, 26, &segment_image_numbers[index_array[1] + page * 32], 32);
-                    ssd1306_display_image(&dev, page, 61, &segment_image_numbers[index_array[2] + page * 32], 32);
-                    ssd1306_display_image(&dev, page, 96, &segment_image_numbers[index_array[3] + page * 32], 32);
+                    dim = !screen_dim;
+                    next_blink += blink_interval;
                 }
             }
+            if (dim != screen_dim || (changes & STATE_CHANGE_SYSTEM_STATE))
+            {
+                ssd1306_contrast(&dev, dim ? 0x00 : 0xFF);
+                screen_dim = dim;
+            }
         }
-        vTaskDelayUntil(&x_last_wake_time, x_frequency);
-    }
-}
-
-esp_err_t conver_bitmap_to_image(uint8_t segment_display[][192], uint8_t *segment_image, size_t image_count)
-{
-    uint8_t *buffer = (uint8_t *)malloc(8 * 128); // 8 page 128 pixel
-    if (buffer == NULL)
-    {
-        return ESP_FAIL;
-    }
 
-    // Convert from segmentDisplay to segmentImage
-    for (int image_index = 0; image_index < image_count; image_index++)
-    {
-        // ssd1306_clear_screen(&dev, false);
-        ssd1306_bitmaps(&dev, 0, 0, segment_display[image_index], 32, 32, false);
-
-        // Get from internal buffer to local buffer
-        // buffer is [8][128] 8 page 128 pixel
-        ssd1306_get_buffer(&dev, buffer);
+        was_blinking = blinking;
 
-        // Save from buffer to segmentImage
-        // segmentImage is [10][8][32] 10 image 8 page 32 pixel
-        int segment_image_index = image_index * 256;
-        for (int page = 0; page < 8; page++)
+        // Sleep until a shown variable changes or the blink timer expires
+        TickType_t timeout = portMAX_DELAY;
+        if (blinking)
+        {
+            TickType_t now = xTaskGetTickCount();
+            timeout = ((int32_t)(next_blink - now) > 0) ? next_blink - now : 0;
+        }
+        if (xTaskNotifyWait(0, UINT32_MAX, &changes, timeout) != pdTRUE)
         {
-            memcpy(&segment_image[segment_image_index + page * 32], &buffer[page * 128], 32);
+            changes = 0;
         }
     }
-    free(buffer);
-    return ESP_OK;
 }
 
 esp_err_t start_screen_handler(void)
@@ -164,71 +283,23 @@ esp_err_t start_screen_handler(void)
     static const char *TAG = "setup_screen";
     ESP_LOGI(TAG, "Screen setup started.");
 
-    // Allocate memory for temporary buffer, Number image buffer and signature image buffer
-    segment_image_numbers = (uint8_t *)malloc(NUMBER_IMAGES * 8 * 32);
-    segment_image_signatures = (uint8_t *)malloc(SIGNATURE_IMAGES * 8 * 32);
-    // segment_image_standby = (uint8_t *)malloc(STANDBY_IMAGES * 8 * 32);
-
-    // If memory allocation fails, handle error.
-    if (segment_image_numbers == NULL || segment_image_signatures == NULL) // || segment_image_standby == NULL)
-    {
-        ESP_LOGE(TAG, "Segment image memory allocation failed.");
-        return ESP_FAIL;
-    }
-
     // Initial screen setup
     i2c_master_init(&dev, SSD1306_SDA_PIN, SSD1306_SCL_PIN, SSD1306_RST_PIN);
     ssd1306_init(&dev, 128, 32);
     ssd1306_contrast(&dev, 0xff);
     ssd1306_clear_screen(&dev, false);
 
-    esp_err_t ret;
-    if (INVERT_SCREEN)
-    {
-        ret = conver_bitmap_to_image(segment_display_numbers_inverse, segment_image_numbers, NUMBER_IMAGES);
-    }
-    else
-    {
-        ret = conver_bitmap_to_image(segment_display_numbers, segment_image_numbers, NUMBER_IMAGES);
-    }
+    // From here on the panel is drawn in horizontal addressing
+    esp_err_t ret = screen_panel_init(&dev, atomic_load(&screen_rotated));
     if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "Segment image conversion failed.");
+        ESP_LOGE(TAG, "Screen addressing setup failed.");
         return ESP_FAIL;
     }
-    if (INVERT_SCREEN)
-    {
-        ret = conver_bitmap_to_image(segment_display_signatures_inverse, segment_image_signatures, SIGNATURE_IMAGES);
-    }
-    else
-    {
-        ret = conver_bitmap_to_image(segment_display_signatures, segment_image_signatures, SIGNATURE_IMAGES);
-    }
-    if (ret != ESP_OK)
-    {
-        ESP_LOGE(TAG, "Segment image conversion failed.");
-        return ESP_FAIL;
-    }
-    // if (INVERT_SCREEN)
-    // {
-    //     ret = conver_bitmap_to_image(segment_display_standby_inverse, segment_image_standby, STANDBY_IMAGES);
-    // }
-    // else
-    // {
-    //     ret = conver_bitmap_to_image(segment_display_standby, segment_image_standby, STANDBY_IMAGES);
-    // }
-    // if (ret != ESP_OK)
-    // {
-    //     ESP_LOGE(TAG, "Segment image conversion failed.");
-    //     return ESP_FAIL;
-    // }
-
-    // Free the buffer and clear the screen
-    ssd1306_clear_screen(&dev, false);
 
     // Setup task parameters and start the task
     BaseType_t x_returned;
-    x_returned = xTaskCreate(screen_update_handler_task, "screen_update_handler", 2048, NULL, 10, NULL);
+    x_returned = xTaskCreate(screen_update_handler_task, "screen_update_handler", 2048, NULL, 10, &screen_task);
     if (x_returned != pdPASS)
     {
         ESP_LOGE(TAG, "Screen update handler task creation failed.");
@@ -0,0 +1,69 @@
+#include "screen_panel.h"
+#include "driver/i2c.h"
+
+/**
+ * Send a command stream in one transaction
+ *
+ * @param SSD1306_t* dev Panel.
+ * @param const uint8_t* commands Command bytes.
+ * @param size_t length Number of bytes.
+ * @return esp_err_t error from the I2C transaction.
+ */
+static esp_err_t write_commands(SSD1306_t *dev, const uint8_t *commands, size_t length)
+{
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(cmd, SSD1306_CONTROL_COMMAND_STREAM, true);
+    i2c_master_write(cmd, commands, length, true);
+    i2c_master_stop(cmd);
+    esp_err_t ret = i2c_master_cmd_begin(SCREEN_PANEL_I2C_PORT, cmd, pdMS_TO_TICKS(SCREEN_PANEL_TIMEOUT_MS));
+    i2c_cmd_link_delete(cmd);
+    return ret;
+}
+
+esp_err_t screen_panel_init(SSD1306_t *dev, bool rotated)
+{
+    const uint8_t commands[] = {SSD1306_SET_MEMORY_ADDRESSING_MODE, SSD1306_HORIZONTAL_ADDRESSING};
+    esp_err_t ret = write_commands(dev, commands, sizeof(commands));
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return screen_panel_set_rotation(dev, rotated);
+}
+
+esp_err_t screen_panel_set_rotation(SSD1306_t *dev, bool rotated)
+{
+    // The ssd1306 component sets up the reversed remap and scan, mirroring both turns the picture around
+    const uint8_t commands[] = {rotated ? SSD1306_SEGMENT_REMAP_NORMAL : SSD1306_SEGMENT_REMAP_REVERSE,
+                                rotated ? SSD1306_COM_SCAN_NORMAL : SSD1306_COM_SCAN_REVERSE};
+    return write_commands(dev, commands, sizeof(commands));
+}
+
+esp_err_t screen_panel_write_window(SSD1306_t *dev, const uint8_t *frame, uint8_t columns, uint8_t first_page,
+                                    uint8_t last_page, uint8_t first_column, uint8_t last_column)
+{
+    // The address pointer restarts from the window corner on every window set
+    const uint8_t window[] = {SSD1306_SET_COLUMN_ADDRESS, first_column, last_column,
+                              SSD1306_SET_PAGE_ADDRESS, first_page, last_page};
+    esp_err_t ret = write_commands(dev, window, sizeof(window));
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    // One data transaction, the window rows of every page are queued back to back
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(cmd, SSD1306_CONTROL_DATA_STREAM, true);
+    for (int page = first_page; page <= last_page; page++)
+    {
+        i2c_master_write(cmd, &frame[page * columns + first_column], last_column - first_column + 1, true);
+    }
+    i2c_master_stop(cmd);
+    ret = i2c_master_cmd_begin(SCREEN_PANEL_I2C_PORT, cmd, pdMS_TO_TICKS(SCREEN_PANEL_TIMEOUT_MS));
+    i2c_cmd_link_delete(cmd);
+    return ret;
+}
\ No newline at end of file
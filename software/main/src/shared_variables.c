@@ -1,180 +1,282 @@
 #include "shared_variables.h"
 #include "settings.h"
-#include "resources.h"
-
-esp_system_state_t system_state = SYSTEM_ON; // System ON/OFF state
-uint16_t bpm_selected = BPM_START;           // Baseline bpm
-uint16_t bpm_candidate = BPM_START;          // Baseline bpm
-uint16_t signature_mode = SIGNATURE_START;   // Baseline bpm
-uint8_t current_beat = 1;                    // Starting beat
-SemaphoreHandle_t selected_bpm_semaphore = NULL;
-SemaphoreHandle_t candidate_bpm_semaphore = NULL;
-SemaphoreHandle_t signature_semaphore = NULL;
-SemaphoreHandle_t beat_semaphore = NULL;
-SemaphoreHandle_t system_state_semaphore = NULL;
-
-esp_err_t init_semaphores(void)
-{
-    selected_bpm_semaphore = xSemaphoreCreateMutex();
-    candidate_bpm_semaphore = xSemaphoreCreateMutex();
-    signature_semaphore = xSemaphoreCreateMutex();
-    beat_semaphore = xSemaphoreCreateMutex();
-    system_state_semaphore = xSemaphoreCreateMutex();
-
-    // Check that semaphore creation succeeded
-    if (selected_bpm_semaphore == NULL || candidate_bpm_semaphore == NULL || signature_semaphore == NULL || beat_semaphore == NULL || system_state_semaphore == NULL)
-    {
-        return ESP_FAIL;
-    }
-    return ESP_OK;
+#include "meter_patterns.h"
+#include "esp_attr.h"
+#include <stdatomic.h>
+
+// Bit layout of the packed state word
+#define BPM_SELECTED_SHIFT 0
+#define BPM_CANDIDATE_SHIFT 10
+#define SIGNATURE_MODE_SHIFT 20
+#define CURRENT_BEAT_SHIFT 27
+#define SYSTEM_STATE_SHIFT 31
+#define BPM_MASK 0x3FF
+#define SIGNATURE_MODE_MASK 0x7F
+#define CURRENT_BEAT_MASK 0xF // Stored as beat - 1
+
+// Pack state fields into one 32 bit word
+#define PACK_STATE(bpm_selected, bpm_candidate, signature_mode, current_beat, system_state) \
+    ((uint32_t)(bpm_selected) << BPM_SELECTED_SHIFT |                                     \
+     (uint32_t)(bpm_candidate) << BPM_CANDIDATE_SHIFT |                                   \
+     (uint32_t)(signature_mode) << SIGNATURE_MODE_SHIFT |                                 \
+     (uint32_t)((current_beat) - 1) << CURRENT_BEAT_SHIFT |                               \
+     (uint32_t)(system_state) << SYSTEM_STATE_SHIFT)
+
+// All shared variables live in a single atomic word so every read is a consistent snapshot
+static _Atomic uint32_t packed_state = PACK_STATE(BPM_START, BPM_START, SIGNATURE_START, 1, SYSTEM_ON);
+
+// Task notified about the changes, with the changes it is interested in. Read from the beat ISR.
+static _Atomic(TaskHandle_t) subscriber = NULL;
+static _Atomic uint32_t subscriber_mask = 0;
+
+/**
+ * Convert the differing bits of two state words to STATE_CHANGE_* bits
+ *
+ * @param uint32_t diff Old state word XOR new state word.
+ * @return uint32_t changed variables.
+ */
+static inline uint32_t IRAM_ATTR state_changes(uint32_t diff)
+{
+    uint32_t changes = 0;
+    changes |= (diff & (BPM_MASK << BPM_SELECTED_SHIFT)) ? STATE_CHANGE_BPM_SELECTED : 0;
+    changes |= (diff & (BPM_MASK << BPM_CANDIDATE_SHIFT)) ? STATE_CHANGE_BPM_CANDIDATE : 0;
+    changes |= (diff & (SIGNATURE_MODE_MASK << SIGNATURE_MODE_SHIFT)) ? STATE_CHANGE_SIGNATURE_MODE : 0;
+    changes |= (diff & ((uint32_t)CURRENT_BEAT_MASK << CURRENT_BEAT_SHIFT)) ? STATE_CHANGE_CURRENT_BEAT : 0;
+    changes |= (diff & ((uint32_t)1 << SYSTEM_STATE_SHIFT)) ? STATE_CHANGE_SYSTEM_STATE : 0;
+    return changes;
 }
 
-uint8_t get_beat()
+/**
+ * Unpack the state word to a snapshot
+ *
+ * @param uint32_t packed State word.
+ * @param state_snapshot_t* snapshot Snapshot to fill.
+ * @return void.
+ */
+static inline void IRAM_ATTR unpack_state(uint32_t packed, state_snapshot_t *snapshot)
 {
-    uint16_t beat = 1;
-    if (xSemaphoreTake(beat_semaphore, portMAX_DELAY) == pdTRUE)
+    snapshot->bpm_selected = (packed >> BPM_SELECTED_SHIFT) & BPM_MASK;
+    snapshot->bpm_candidate = (packed >> BPM_CANDIDATE_SHIFT) & BPM_MASK;
+    snapshot->signature_mode = (packed >> SIGNATURE_MODE_SHIFT) & SIGNATURE_MODE_MASK;
+    snapshot->current_beat = ((packed >> CURRENT_BEAT_SHIFT) & CURRENT_BEAT_MASK) + 1;
+    snapshot->system_state = (esp_system_state_t)(packed >> SYSTEM_STATE_SHIFT);
+}
+
+/**
+ * Apply a modification to the state and publish it with a single compare and swap
+ *
+ * @param modify Function modifying the snapshot in place.
+ * @param int32_t arg Argument passed to the modify function.
+ * @param BaseType_t* high_task_awoken Set if the subscriber was woken, NULL when called from a task.
+ * @return void.
+ */
+static void IRAM_ATTR modify_state(void (*modify)(state_snapshot_t *, int32_t), int32_t arg, BaseType_t *high_task_awoken)
+{
+    uint32_t old_packed = atomic_load(&packed_state);
+    uint32_t new_packed;
+    state_snapshot_t snapshot;
+    do
+    {
+        unpack_state(old_packed, &snapshot);
+        modify(&snapshot, arg);
+        new_packed = PACK_STATE(snapshot.bpm_selected, snapshot.bpm_candidate, snapshot.signature_mode,
+                                snapshot.current_beat, snapshot.system_state);
+    } while (!atomic_compare_exchange_weak(&packed_state, &old_packed, new_packed));
+
+    // Publish the change to the subscriber, unchanged writes wake nobody
+    TaskHandle_t task = atomic_load_explicit(&subscriber, memory_order_acquire);
+    uint32_t changes = state_changes(old_packed ^ new_packed) & atomic_load_explicit(&subscriber_mask, memory_order_relaxed);
+    if (changes == 0 || task == NULL)
     {
-        beat = current_beat;
-        xSemaphoreGive(beat_semaphore); // Release the mutex
+        return;
     }
-    return beat;
+    if (high_task_awoken != NULL)
+    {
+        // The ISR yields on its way out, e.g. through the return value of a gptimer callback
+        xTaskNotifyFromISR(task, changes, eSetBits, high_task_awoken);
+    }
+    else
+    {
+        xTaskNotify(task, changes, eSetBits);
+    }
+}
+
+// State modifiers, applied through modify_state
+static void IRAM_ATTR increment_beat_modifier(state_snapshot_t *snapshot, int32_t arg)
+{
+    snapshot->current_beat = (snapshot->current_beat >= get_meter_pattern(snapshot->signature_mode)->length) ? 1 : snapshot->current_beat + 1;
+}
+
+static void reset_beat_modifier(state_snapshot_t *snapshot, int32_t arg)
+{
+    snapshot->current_beat = 1;
 }
 
-void increment_beat()
+static void change_signature_mode_modifier(state_snapshot_t *snapshot, int32_t arg)
 {
-    if (xSemaphoreTake(beat_semaphore, portMAX_DELAY) == pdTRUE)
+    snapshot->signature_mode = (snapshot->signature_mode < METER_PATTERN_COUNT - 1) ? snapshot->signature_mode + 1 : 0;
+    if (snapshot->current_beat > get_meter_pattern(snapshot->signature_mode)->length)
     {
-        if (current_beat >= signature_modes[get_signature_mode()])
-        {
-            current_beat = 1;
-        }
-        else
-        {
-            current_beat++;
-        }
-        xSemaphoreGive(beat_semaphore); // Release the mutex
+        snapshot->current_beat = 1;
     }
 }
 
-void change_signature_mode(void)
+static void set_signature_mode_modifier(state_snapshot_t *snapshot, int32_t signature_mode)
 {
-    if (xSemaphoreTake(signature_semaphore, portMAX_DELAY) == pdTRUE)
+    snapshot->signature_mode = signature_mode % METER_PATTERN_COUNT;
+    if (snapshot->current_beat > get_meter_pattern(snapshot->signature_mode)->length)
     {
-        if (signature_mode < SIGNATURE_IMAGES - 1)
-        {
-            signature_mode++;
-        }
-        else
-        {
-            signature_mode = 0;
-        }
-        xSemaphoreGive(signature_semaphore); // Release the mutex
+        snapshot->current_beat = 1;
     }
 }
 
-uint16_t get_signature_mode(void)
+static void change_bpm_modifier(state_snapshot_t *snapshot, int32_t bpm_delta)
+{
+    int32_t new_bpm = snapshot->bpm_candidate + bpm_delta;
+    snapshot->bpm_candidate = (new_bpm > 999) ? 999 : (new_bpm < 1 ? 1 : new_bpm);
+}
+
+static void select_bpm_modifier(state_snapshot_t *snapshot, int32_t arg)
 {
-    uint16_t mode = SIGNATURE_START;
-    if (xSemaphoreTake(signature_semaphore, portMAX_DELAY) == pdTRUE)
+    snapshot->bpm_selected = snapshot->bpm_candidate;
+}
+
+static void follow_bpm_modifier(state_snapshot_t *snapshot, int32_t bpm)
+{
+    // The candidate follows unless the user is changing it
+    if (snapshot->bpm_candidate == snapshot->bpm_selected)
     {
-        mode = signature_mode;
-        xSemaphoreGive(signature_semaphore); // Release the mutex
+        snapshot->bpm_candidate = bpm;
     }
-    return mode;
+    snapshot->bpm_selected = bpm;
+}
+
+static void reset_candidate_bpm_modifier(state_snapshot_t *snapshot, int32_t arg)
+{
+    snapshot->bpm_candidate = snapshot->bpm_selected;
 }
 
-void change_bpm(uint16_t bpm_delta)
+static void set_system_state_modifier(state_snapshot_t *snapshot, int32_t state)
 {
-    if (xSemaphoreTake(candidate_bpm_semaphore, portMAX_DELAY) == pdTRUE)
+    snapshot->system_state = (esp_system_state_t)state;
+}
+
+esp_err_t init_shared_variables(void)
+{
+    // Check that the state word is lock free so it can be used from ISRs
+    if (!atomic_is_lock_free(&packed_state))
     {
-        uint16_t new_bpm = bpm_candidate + bpm_delta;
-        bpm_candidate = (new_bpm > 999) ? 999 : (new_bpm < 1 ? 1 : new_bpm);
-        xSemaphoreGive(candidate_bpm_semaphore); // Release the mutex
+        return ESP_FAIL;
     }
+    return ESP_OK;
+}
+
+void subscribe_state_changes(TaskHandle_t task, uint32_t mask)
+{
+    // Detach the old task first so the ISR never pairs the new mask with it
+    atomic_store_explicit(&subscriber, NULL, memory_order_release);
+    atomic_store_explicit(&subscriber_mask, mask, memory_order_relaxed);
+    atomic_store_explicit(&subscriber, task, memory_order_release);
+}
+
+void IRAM_ATTR get_state_snapshot(state_snapshot_t *snapshot)
+{
+    unpack_state(atomic_load(&packed_state), snapshot);
+}
+
+uint8_t IRAM_ATTR get_beat(void)
+{
+    state_snapshot_t snapshot;
+    get_state_snapshot(&snapshot);
+    return snapshot.current_beat;
+}
+
+void increment_beat(void)
+{
+    modify_state(increment_beat_modifier, 0, NULL);
+}
+
+void IRAM_ATTR increment_beat_from_isr(BaseType_t *high_task_awoken)
+{
+    modify_state(increment_beat_modifier, 0, high_task_awoken);
+}
+
+void reset_beat(void)
+{
+    modify_state(reset_beat_modifier, 0, NULL);
+}
+
+void change_signature_mode(void)
+{
+    modify_state(change_signature_mode_modifier, 0, NULL);
+}
+
+void set_signature_mode(uint16_t signature_mode)
+{
+    modify_state(set_signature_mode_modifier, signature_mode, NULL);
+}
+
+uint16_t IRAM_ATTR get_signature_mode(void)
+{
+    state_snapshot_t snapshot;
+    get_state_snapshot(&snapshot);
+    return snapshot.signature_mode;
+}
+
+void change_bpm(int16_t bpm_delta)
+{
+    modify_state(change_bpm_modifier, bpm_delta, NULL);
 }
 
 void select_bpm(void)
 {
-    if (xSemaphoreTake(selected_bpm_semaphore, portMAX_DELAY) == pdTRUE &&
-        xSemaphoreTake(candidate_bpm_semaphore, portMAX_DELAY) == pdTRUE)
-    {
-        bpm_selected = bpm_candidate;
-        xSemaphoreGive(candidate_bpm_semaphore); // Release the mutex
-        xSemaphoreGive(selected_bpm_semaphore);  // Release the mutex
-    }
+    modify_state(select_bpm_modifier, 0, NULL);
 }
 
-uint16_t get_selected_bpm(void)
+uint16_t IRAM_ATTR get_selected_bpm(void)
 {
-    uint16_t bpm = BPM_START;
-    if (xSemaphoreTake(selected_bpm_semaphore, portMAX_DELAY) == pdTRUE)
-    {
-        bpm = bpm_selected;
-        xSemaphoreGive(selected_bpm_semaphore); // Release the mutex
-    }
-    return bpm;
+    state_snapshot_t snapshot;
+    get_state_snapshot(&snapshot);
+    return snapshot.bpm_selected;
 }
 
 uint16_t get_candidate_bpm(void)
 {
-    uint16_t bpm = BPM_START;
-    if (xSemaphoreTake(candidate_bpm_semaphore, portMAX_DELAY) == pdTRUE)
-    {
-        bpm = bpm_candidate;
-        xSemaphoreGive(candidate_bpm_semaphore); // Release the mutex
-    }
-    return bpm;
+    state_snapshot_t snapshot;
+    get_state_snapshot(&snapshot);
+    return snapshot.bpm_candidate;
+}
+
+void set_followed_bpm(uint16_t bpm)
+{
+    modify_state(follow_bpm_modifier, (bpm > 999) ? 999 : (bpm < 1 ? 1 : bpm), NULL);
 }
 
 void reset_candidate_bpm(void)
 {
-    if (xSemaphoreTake(selected_bpm_semaphore, portMAX_DELAY) == pdTRUE &&
-        xSemaphoreTake(candidate_bpm_semaphore, portMAX_DELAY) == pdTRUE)
-    {
-        bpm_candidate = bpm_selected;
-        xSemaphoreGive(candidate_bpm_semaphore); // Release the mutex
-        xSemaphoreGive(selected_bpm_semaphore);  // Release the mutex
-    }
+    modify_state(reset_candidate_bpm_modifier, 0, NULL);
 }
 
 bool bpm_selcted(void)
 {
-    bool equal = false;
-    if (xSemaphoreTake(selected_bpm_semaphore, portMAX_DELAY) == pdTRUE &&
-        xSemaphoreTake(candidate_bpm_semaphore, portMAX_DELAY) == pdTRUE)
-    {
-        equal = (bpm_selected == bpm_candidate);
-        xSemaphoreGive(candidate_bpm_semaphore); // Release the mutex
-        xSemaphoreGive(selected_bpm_semaphore);  // Release the mutex
-    }
-    return equal;
+    state_snapshot_t snapshot;
+    get_state_snapshot(&snapshot);
+    return snapshot.bpm_selected == snapshot.bpm_candidate;
 }
 
-esp_system_state_t get_system_state(void)
+esp_system_state_t IRAM_ATTR get_system_state(void)
 {
-    esp_system_state_t state = SYSTEM_ON;
-    if (xSemaphoreTake(system_state_semaphore, portMAX_DELAY) == pdTRUE)
-    {
-        state = system_state;
-        xSemaphoreGive(system_state_semaphore);  // Release the mutex
-    }
-    return state;
+    state_snapshot_t snapshot;
+    get_state_snapshot(&snapshot);
+    return snapshot.system_state;
 }
 
 void switch_system_off(void)
 {
-    if (xSemaphoreTake(system_state_semaphore, portMAX_DELAY) == pdTRUE)
-    {
-        system_state = SYSTEM_OFF;
-        xSemaphoreGive(system_state_semaphore);  // Release the mutex
-    }
+    modify_state(set_system_state_modifier, SYSTEM_OFF, NULL);
 }
 
 void switch_system_on(void)
-{    
-    if (xSemaphoreTake(system_state_semaphore, portMAX_DELAY) == pdTRUE)
-    {
-        system_state = SYSTEM_ON;
-        xSemaphoreGive(system_state_semaphore);  // Release the mutex
-    }
+{
+    modify_state(set_system_state_modifier, SYSTEM_ON, NULL);
 }
\ No newline at end of file
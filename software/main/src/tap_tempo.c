@@ -0,0 +1,138 @@
+#include "tap_tempo.h"
+#include "beat_scheduler.h"
+#include <string.h>
+
+/**
+ * Find the position of a value in the sorted window with binary search
+ *
+ * @param const tap_tempo_t* tap_tempo Estimator.
+ * @param uint32_t interval Value to find.
+ * @return uint8_t index of the first value not less than interval.
+ */
+static uint8_t sorted_position(const tap_tempo_t *tap_tempo, uint32_t interval)
+{
+    uint8_t low = 0;
+    uint8_t high = tap_tempo->count;
+    while (low < high)
+    {
+        uint8_t middle = (low + high) / 2;
+        if (tap_tempo->sorted[middle] < interval)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Return the median interval of the window
+ *
+ * @param const tap_tempo_t* tap_tempo Estimator with at least one interval.
+ * @return uint32_t median interval in microseconds.
+ */
+static uint32_t median_interval(const tap_tempo_t *tap_tempo)
+{
+    uint8_t middle = tap_tempo->count / 2;
+    if (tap_tempo->count % 2 == 1)
+    {
+        return tap_tempo->sorted[middle];
+    }
+    return (tap_tempo->sorted[middle - 1] + tap_tempo->sorted[middle]) / 2;
+}
+
+/**
+ * Add an interval to the window, dropping the oldest one when the window is full
+ *
+ * @param tap_tempo_t* tap_tempo Estimator to update.
+ * @param uint32_t interval Interval in microseconds.
+ * @return void.
+ */
+static void add_interval(tap_tempo_t *tap_tempo, uint32_t interval)
+{
+    if (tap_tempo->count == TAP_TEMPO_WINDOW)
+    {
+        // Remove the oldest interval from both orders
+        uint32_t oldest = tap_tempo->intervals[tap_tempo->head];
+        tap_tempo->head = (tap_tempo->head + 1) % TAP_TEMPO_WINDOW;
+        uint8_t position = sorted_position(tap_tempo, oldest);
+        tap_tempo->count--;
+        memmove(&tap_tempo->sorted[position], &tap_tempo->sorted[position + 1], (tap_tempo->count - position) * sizeof(uint32_t));
+    }
+
+    // Append to the ring and insert to the sorted order
+    tap_tempo->intervals[(tap_tempo->head + tap_tempo->count) % TAP_TEMPO_WINDOW] = interval;
+    uint8_t position = sorted_position(tap_tempo, interval);
+    memmove(&tap_tempo->sorted[position + 1], &tap_tempo->sorted[position], (tap_tempo->count - position) * sizeof(uint32_t));
+    tap_tempo->sorted[position] = interval;
+    tap_tempo->count++;
+}
+
+void tap_tempo_init(tap_tempo_t *tap_tempo)
+{
+    memset(tap_tempo, 0, sizeof(*tap_tempo));
+}
+
+bool tap_tempo_active(const tap_tempo_t *tap_tempo, uint64_t now)
+{
+    return tap_tempo->last_tap != 0 && now - tap_tempo->last_tap < TAP_TEMPO_TIMEOUT_US;
+}
+
+bool tap_tempo_tap(tap_tempo_t *tap_tempo, uint64_t time)
+{
+    // A long pause starts a new sequence from this tap
+    if (!tap_tempo_active(tap_tempo, time))
+    {
+        tap_tempo_init(tap_tempo);
+        tap_tempo->last_tap = time;
+        return false;
+    }
+
+    // Ignore contact bounces and double taps
+    uint32_t interval = time - tap_tempo->last_tap;
+    if (interval < TAP_TEMPO_MIN_INTERVAL_US)
+    {
+        return false;
+    }
+    tap_tempo->last_tap = time;
+
+    // Reject intervals far from the median, unless they repeat and the player has changed the tempo
+    if (tap_tempo->count >= TAP_TEMPO_MIN_INTERVALS)
+    {
+        uint32_t median = median_interval(tap_tempo);
+        uint32_t deviation = (interval > median) ? interval - median : median - interval;
+        if ((uint64_t)deviation * 100 > (uint64_t)median * TAP_TEMPO_OUTLIER_PERCENT)
+        {
+            uint32_t outlier_deviation = (interval > tap_tempo->last_outlier) ? interval - tap_tempo->last_outlier : tap_tempo->last_outlier - interval;
+            bool consistent = (uint64_t)outlier_deviation * 100 <= (uint64_t)interval * TAP_TEMPO_OUTLIER_PERCENT;
+            tap_tempo->outliers = (tap_tempo->outliers > 0 && consistent) ? tap_tempo->outliers + 1 : 1;
+            tap_tempo->last_outlier = interval;
+            if (tap_tempo->outliers <= TAP_TEMPO_MAX_OUTLIERS)
+            {
+                return false;
+            }
+
+            // Start over from the new tempo
+            tap_tempo->count = 0;
+            tap_tempo->head = 0;
+        }
+    }
+    tap_tempo->outliers = 0;
+    add_interval(tap_tempo, interval);
+    return true;
+}
+
+esp_err_t tap_tempo_get_bpm(const tap_tempo_t *tap_tempo, uint16_t *bpm)
+{
+    if (tap_tempo->count < TAP_TEMPO_MIN_INTERVALS)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    uint32_t median = median_interval(tap_tempo);
+    uint32_t rounded = (US_PER_MINUTE + median / 2) / median;
+    *bpm = (rounded > 999) ? 999 : (rounded < 1 ? 1 : rounded);
+    return ESP_OK;
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "tempo_automation.h"
+#include "beat_scheduler.h"
+#include "esp_attr.h"
+#include <string.h>
+
+#define FRACTION_MASK ((1ULL << TEMPO_AUTOMATION_FRACTION_BITS) - 1)
+#define BPM_FRACTION_BITS 16 // Fractional bits of the fixed point bpm used while building ramps
+
+/**
+ * Convert a fixed point bpm to a fixed point beat interval
+ *
+ * @param uint32_t bpm Tempo in Q16.16 beats per minute.
+ * @return uint64_t beat interval in Q32.32 microseconds.
+ */
+static uint64_t bpm_to_interval(uint32_t bpm)
+{
+    // Divide in two steps to keep the intermediate values within 64 bits
+    uint64_t dividend = US_PER_MINUTE << TEMPO_AUTOMATION_FRACTION_BITS;
+    uint64_t quotient = dividend / bpm;
+    uint64_t remainder = dividend % bpm;
+    return (quotient << BPM_FRACTION_BITS) + (remainder << BPM_FRACTION_BITS) / bpm;
+}
+
+/**
+ * Append a linear segment to the segment table
+ *
+ * @param tempo_automation_t* automation Automation to modify.
+ * @param uint32_t beats Beats in the segment.
+ * @param uint64_t interval Interval after the first beat, Q32.32 microseconds.
+ * @param int64_t interval_step Change of the interval per beat, Q32.32 microseconds.
+ * @return void.
+ */
+static void add_segment(tempo_automation_t *automation, uint32_t beats, uint64_t interval, int64_t interval_step)
+{
+    tempo_segment_t *segment = &automation->segments[automation->segment_count++];
+    memset(segment, 0, sizeof(*segment));
+    segment->type = TEMPO_SEGMENT_LINEAR;
+    segment->beats = beats;
+    segment->interval = interval;
+    segment->interval_step = interval_step;
+}
+
+void tempo_automation_init(tempo_automation_t *automation)
+{
+    memset(automation, 0, sizeof(*automation));
+}
+
+esp_err_t tempo_automation_add_hold(tempo_automation_t *automation, uint16_t bpm, uint32_t beats)
+{
+    if (bpm < 1 || bpm > 999 || beats == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (automation->segment_count >= TEMPO_AUTOMATION_MAX_SEGMENTS)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    add_segment(automation, beats, bpm_to_interval((uint32_t)bpm << BPM_FRACTION_BITS), 0);
+    automation->last_bpm = bpm;
+    return ESP_OK;
+}
+
+esp_err_t tempo_automation_add_ramp(tempo_automation_t *automation, uint16_t bpm_from, uint16_t bpm_to, uint32_t beats)
+{
+    if (bpm_from < 1 || bpm_from > 999 || bpm_to < 1 || bpm_to > 999 || beats == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Follow the bpm ramp with pieces where the interval changes linearly
+    uint32_t pieces = (beats < TEMPO_AUTOMATION_RAMP_PIECES) ? beats : TEMPO_AUTOMATION_RAMP_PIECES;
+    if (automation->segment_count + pieces > TEMPO_AUTOMATION_MAX_SEGMENTS)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    int64_t bpm_span = ((int64_t)bpm_to - bpm_from) << BPM_FRACTION_BITS;
+    uint32_t bpm_start = (uint32_t)bpm_from << BPM_FRACTION_BITS;
+    for (uint32_t piece = 0; piece < pieces; piece++)
+    {
+        uint32_t first_beat = (uint64_t)beats * piece / pieces;
+        uint32_t last_beat = (uint64_t)beats * (piece + 1) / pieces;
+        uint64_t interval_first = bpm_to_interval(bpm_start + bpm_span * first_beat / beats);
+        uint64_t interval_last = bpm_to_interval(bpm_start + bpm_span * last_beat / beats);
+        uint32_t piece_beats = last_beat - first_beat;
+        add_segment(automation, piece_beats, interval_first, ((int64_t)interval_last - (int64_t)interval_first) / piece_beats);
+    }
+    automation->last_bpm = bpm_to;
+    return ESP_OK;
+}
+
+esp_err_t tempo_automation_add_steps(tempo_automation_t *automation, uint16_t bpm_from, uint16_t bpm_step,
+                                     uint32_t beats_per_step, uint16_t bpm_ceiling)
+{
+    if (bpm_from < 1 || bpm_ceiling > 999 || bpm_ceiling < bpm_from || bpm_step == 0 || beats_per_step == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t steps = (bpm_ceiling - bpm_from + bpm_step - 1) / bpm_step + 1;
+    if (automation->segment_count >= TEMPO_AUTOMATION_MAX_SEGMENTS || automation->step_count + steps > TEMPO_AUTOMATION_MAX_STEPS)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // All steps share one segment, the last step is clamped to the ceiling
+    tempo_segment_t *segment = &automation->segments[automation->segment_count++];
+    memset(segment, 0, sizeof(*segment));
+    segment->type = TEMPO_SEGMENT_STEPS;
+    segment->beats = beats_per_step;
+    segment->first_step = automation->step_count;
+    segment->steps = steps;
+    for (uint16_t step = 0; step < steps; step++)
+    {
+        uint32_t bpm = bpm_from + (uint32_t)step * bpm_step;
+        bpm = (bpm > bpm_ceiling) ? bpm_ceiling : bpm;
+        automation->step_intervals[automation->step_count++] = bpm_to_interval(bpm << BPM_FRACTION_BITS);
+    }
+    automation->last_bpm = bpm_ceiling;
+    return ESP_OK;
+}
+
+void tempo_automation_rewind(tempo_automation_t *automation)
+{
+    automation->segment = 0;
+    automation->step = 0;
+    automation->beat = 0;
+    automation->fraction = 0;
+}
+
+bool IRAM_ATTR tempo_automation_done(const tempo_automation_t *automation)
+{
+    return automation->segment >= automation->segment_count;
+}
+
+uint32_t IRAM_ATTR tempo_automation_next_interval(tempo_automation_t *automation)
+{
+    if (tempo_automation_done(automation))
+    {
+        return 0;
+    }
+
+    // Load the starting interval of a new segment or step
+    const tempo_segment_t *segment = &automation->segments[automation->segment];
+    if (automation->beat == 0)
+    {
+        automation->interval = (segment->type == TEMPO_SEGMENT_STEPS) ? automation->step_intervals[segment->first_step + automation->step] : segment->interval;
+    }
+
+    // Output whole microseconds and carry the fraction to the next beat
+    uint64_t interval = automation->interval + automation->fraction;
+    automation->fraction = interval & FRACTION_MASK;
+    automation->interval += segment->interval_step;
+    if (++automation->beat >= segment->beats)
+    {
+        automation->beat = 0;
+        if (segment->type != TEMPO_SEGMENT_STEPS || ++automation->step >= segment->steps)
+        {
+            automation->segment++;
+            automation->step = 0;
+        }
+    }
+    return (uint32_t)(interval >> TEMPO_AUTOMATION_FRACTION_BITS);
+}
\ No newline at end of file
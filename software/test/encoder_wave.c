@@ -0,0 +1,52 @@
+#include "encoder_wave.h"
+#include <stdlib.h>
+
+#define MAX_BOUNCES 4 // Bounces of one edge, each toggles the pin twice
+
+static double uniform(void)
+{
+    return rand() / (double)RAND_MAX;
+}
+
+static int compare_edges(const void *a, const void *b)
+{
+    double difference = ((const encoder_edge_t *)a)->time - ((const encoder_edge_t *)b)->time;
+    return (difference > 0) - (difference < 0);
+}
+
+int32_t encoder_wave_generate(const encoder_wave_t *wave, encoder_edge_t **edges, int32_t *net_detents)
+{
+    *edges = malloc(sizeof(encoder_edge_t) * wave->detents * 4 * (1 + 2 * MAX_BOUNCES));
+    int32_t count = 0;
+    *net_detents = 0;
+    double period = 1e6 / wave->edges_per_second;
+    double time = 1000;
+    int direction = 1;
+    for (int32_t detent = 0; detent < wave->detents; detent++)
+    {
+        if (detent % wave->run_detents == 0)
+        {
+            direction = (uniform() < 0.5) ? 1 : -1;
+        }
+        *net_detents += direction;
+
+        // From rest clockwise A falls, B falls, A rises and B rises, counterclockwise B leads
+        for (int edge = 0; edge < 4; edge++)
+        {
+            uint8_t pin = ((edge % 2 == 0) == (direction > 0)) ? ENCODER_WAVE_PIN_A : ENCODER_WAVE_PIN_B;
+            double edge_time = time + period * 0.3 * (uniform() - 0.5);
+            (*edges)[count++] = (encoder_edge_t){edge_time, pin};
+            if (uniform() < wave->bounce_probability)
+            {
+                int toggles = 2 * (1 + rand() % MAX_BOUNCES);
+                for (int toggle = 0; toggle < toggles; toggle++)
+                {
+                    (*edges)[count++] = (encoder_edge_t){edge_time + uniform() * wave->bounce_us, pin};
+                }
+            }
+            time += period;
+        }
+    }
+    qsort(*edges, count, sizeof(encoder_edge_t), compare_edges);
+    return count;
+}
\ No newline at end of file
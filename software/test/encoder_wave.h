@@ -0,0 +1,44 @@
+#ifndef ENCODER_WAVE_H
+#define ENCODER_WAVE_H
+
+#include <stdint.h>
+
+// Synthetic A and B waveforms of a mechanical encoder for the host tests of the encoder reader backends.
+// The turn direction changes at random every run of detents, the edges are jittered and followed by bounce.
+
+#define ENCODER_WAVE_PIN_A 0
+#define ENCODER_WAVE_PIN_B 1
+
+/**
+ * @brief Shape of a generated waveform
+ */
+typedef struct
+{
+    double edges_per_second; // Quadrature edges of A and B together, 4 per detent
+    double bounce_probability; // Chance of an edge to bounce
+    double bounce_us;        // Bounce lasts up to this long after the edge
+    int32_t detents;         // Detents turned
+    int32_t run_detents;     // Detents turned before the direction may change
+} encoder_wave_t;
+
+/**
+ * @brief Level change of one pin
+ */
+typedef struct
+{
+    double time; // Microseconds from the start of the waveform
+    uint8_t pin; // ENCODER_WAVE_PIN_A or ENCODER_WAVE_PIN_B
+} encoder_edge_t;
+
+/**
+ * Generate the edges of a waveform starting and ending at rest with both pins high. Every bounce toggles the pin
+ * an even number of times, so each pin settles at the level of its edge.
+ *
+ * @param const encoder_wave_t* wave Shape of the waveform.
+ * @param encoder_edge_t** edges Output, the edges in time order, to be freed by the caller.
+ * @param int32_t* net_detents Output, detents turned clockwise minus counterclockwise.
+ * @return int32_t number of edges.
+ */
+int32_t encoder_wave_generate(const encoder_wave_t *wave, encoder_edge_t **edges, int32_t *net_detents);
+
+#endif // ENCODER_WAVE_H
\ No newline at end of file
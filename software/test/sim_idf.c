@@ -0,0 +1,458 @@
+#include "sim_idf.h"
+#include "driver/gptimer.h"
+#include "driver/uart.h"
+#include "hal/uart_ll.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_TIMERS 4     // gptimers that can be created
+#define SIM_ESP_TIMERS 8 // esp_timers that can be created
+#define SIM_PINS 64      // GPIO pins
+
+// Simulated gptimer, counting the shared simulated time
+struct gptimer_t
+{
+    gptimer_alarm_cb_t on_alarm;
+    void *user_data;
+    uint64_t alarm; // Pending alarm, UINT64_MAX when none
+};
+
+// Simulated esp_timer, its callback is run by sim_run_until like the gptimer alarms
+struct esp_timer
+{
+    esp_timer_cb_t callback;
+    void *arg;
+    uint64_t alarm; // Pending timeout, UINT64_MAX when stopped
+};
+
+// Simulated queue, a ring of items copied in and out
+struct QueueDefinition
+{
+    uint8_t *items;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+// Handler added for a GPIO interrupt
+typedef struct
+{
+    gpio_isr_t handler;
+    void *arg;
+} sim_gpio_isr_t;
+
+static struct gptimer_t timers[SIM_TIMERS];
+static int timer_count = 0;
+static struct esp_timer esp_timers[SIM_ESP_TIMERS];
+static int esp_timer_count = 0;
+static uint64_t now = 0;
+static uint32_t max_latency_us = 0;
+static sim_gpio_hook_t gpio_hook = NULL;
+static int input_levels[SIM_PINS];
+static sim_gpio_isr_t gpio_isrs[SIM_PINS];
+static sim_uart_hook_t uart_hook = NULL;
+static uint32_t uart_fifo_room = 128;
+
+uint64_t sim_time(void)
+{
+    return now;
+}
+
+void sim_run_until(uint64_t time)
+{
+    while (1)
+    {
+        // Play the earliest alarm, an alarm set to the past fires right away
+        struct gptimer_t *next = NULL;
+        for (int i = 0; i < timer_count; i++)
+        {
+            if (timers[i].alarm <= time && (next == NULL || timers[i].alarm < next->alarm))
+            {
+                next = &timers[i];
+            }
+        }
+        struct esp_timer *next_esp = NULL;
+        for (int i = 0; i < esp_timer_count; i++)
+        {
+            if (esp_timers[i].alarm <= time && (next_esp == NULL || esp_timers[i].alarm < next_esp->alarm))
+            {
+                next_esp = &esp_timers[i];
+            }
+        }
+        if (next == NULL && next_esp == NULL)
+        {
+            break;
+        }
+
+        // The esp_timer callbacks run from a task, they get no ISR latency
+        if (next == NULL || (next_esp != NULL && next_esp->alarm < next->alarm))
+        {
+            now = (next_esp->alarm > now) ? next_esp->alarm : now;
+            next_esp->alarm = UINT64_MAX;
+            next_esp->callback(next_esp->arg);
+            continue;
+        }
+        gptimer_alarm_event_data_t edata = {.alarm_value = next->alarm};
+        uint64_t fire_time = (next->alarm > now) ? next->alarm : now;
+        now = fire_time + ((max_latency_us > 0) ? (uint32_t)rand() % (max_latency_us + 1) : 0);
+        edata.count_value = now;
+        next->alarm = UINT64_MAX;
+        if (next->on_alarm != NULL)
+        {
+            next->on_alarm(next, &edata, next->user_data);
+        }
+    }
+    now = (time > now) ? time : now;
+}
+
+void sim_set_isr_latency(uint32_t latency_us, unsigned seed)
+{
+    max_latency_us = latency_us;
+    srand(seed);
+}
+
+void sim_set_gpio_hook(sim_gpio_hook_t hook)
+{
+    gpio_hook = hook;
+}
+
+void sim_set_input_level(gpio_num_t pin, int level)
+{
+    input_levels[pin] = level;
+}
+
+bool sim_fire_gpio_isr(gpio_num_t pin)
+{
+    if (gpio_isrs[pin].handler == NULL)
+    {
+        return false;
+    }
+    gpio_isrs[pin].handler(gpio_isrs[pin].arg);
+    return true;
+}
+
+void sim_set_uart_hook(sim_uart_hook_t hook)
+{
+    uart_hook = hook;
+}
+
+void sim_set_uart_fifo_room(uint32_t room)
+{
+    uart_fifo_room = room;
+}
+
+// gptimer
+esp_err_t gptimer_new_timer(const gptimer_config_t *config, gptimer_handle_t *ret_timer)
+{
+    if (timer_count >= SIM_TIMERS)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct gptimer_t *timer = &timers[timer_count++];
+    timer->alarm = UINT64_MAX;
+    *ret_timer = timer;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_register_event_callbacks(gptimer_handle_t timer, const gptimer_event_callbacks_t *cbs, void *user_data)
+{
+    timer->on_alarm = cbs->on_alarm;
+    timer->user_data = user_data;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_alarm_action(gptimer_handle_t timer, const gptimer_alarm_config_t *config)
+{
+    timer->alarm = config->alarm_count;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_get_raw_count(gptimer_handle_t timer, uint64_t *value)
+{
+    *value = now;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_enable(gptimer_handle_t timer)
+{
+    return ESP_OK;
+}
+
+esp_err_t gptimer_start(gptimer_handle_t timer)
+{
+    return ESP_OK;
+}
+
+// GPIO
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_hook != NULL)
+    {
+        gpio_hook(gpio_num, level);
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    return input_levels[gpio_num];
+}
+
+// The tests fire the added handlers at the edge times with sim_fire_gpio_isr
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    gpio_isrs[gpio_num] = (sim_gpio_isr_t){isr_handler, args};
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    gpio_isrs[gpio_num] = (sim_gpio_isr_t){NULL, NULL};
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num)
+{
+    return ESP_OK;
+}
+
+// UART
+esp_err_t uart_param_config(int uart_num, const uart_config_t *config)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(int uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num)
+{
+    return ESP_OK;
+}
+
+// The UART receiver is not simulated, the tests hand the received bytes to the modules
+esp_err_t uart_driver_install(int uart_num, int rx_buffer_size, int tx_buffer_size, int queue_size, QueueHandle_t *uart_queue, int intr_alloc_flags)
+{
+    *uart_queue = NULL;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_rx_full_threshold(int uart_num, int threshold)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_flush_input(int uart_num)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_get_buffered_data_len(int uart_num, size_t *size)
+{
+    *size = 0;
+    return ESP_OK;
+}
+
+int uart_read_bytes(int uart_num, void *buf, uint32_t length, TickType_t ticks_to_wait)
+{
+    return 0;
+}
+
+uint32_t uart_ll_get_txfifo_len(uart_dev_t *hw)
+{
+    return uart_fifo_room;
+}
+
+void uart_ll_write_txfifo(uart_dev_t *hw, const uint8_t *buf, uint32_t wr_len)
+{
+    if (uart_hook != NULL)
+    {
+        uart_hook(buf, wr_len);
+    }
+}
+
+// esp_timer
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)now;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    // Reuse the slot of a deleted timer
+    struct esp_timer *timer = NULL;
+    for (int i = 0; i < esp_timer_count && timer == NULL; i++)
+    {
+        timer = (esp_timers[i].callback == NULL) ? &esp_timers[i] : NULL;
+    }
+    if (timer == NULL && esp_timer_count >= SIM_ESP_TIMERS)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    timer = (timer == NULL) ? &esp_timers[esp_timer_count++] : timer;
+    *timer = (struct esp_timer){create_args->callback, create_args->arg, UINT64_MAX};
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->alarm != UINT64_MAX)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm = now + timeout_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_restart(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->alarm == UINT64_MAX)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm = now + timeout_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer->alarm == UINT64_MAX)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm = UINT64_MAX;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    *timer = (struct esp_timer){NULL, NULL, UINT64_MAX};
+    return ESP_OK;
+}
+
+// Heap
+void *heap_caps_calloc(size_t n, size_t size, unsigned caps)
+{
+    return calloc(n, size);
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+// FreeRTOS, the tasks are not run, the tests call the module functions directly
+BaseType_t xTaskCreate(void (*task)(void *), const char *name, uint32_t stack, void *arg, UBaseType_t priority, TaskHandle_t *handle)
+{
+    if (handle != NULL)
+    {
+        *handle = NULL;
+    }
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *high_task_awoken)
+{
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    return 0;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = calloc(1, sizeof(struct QueueDefinition));
+    if (queue != NULL)
+    {
+        queue->items = calloc(length, item_size);
+        queue->length = length;
+        queue->item_size = item_size;
+    }
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    // Nothing else runs while a sender waits, a full queue fails right away
+    if (queue->count == queue->length)
+    {
+        return pdFALSE;
+    }
+    memcpy(&queue->items[((queue->head + queue->count) % queue->length) * queue->item_size], item, queue->item_size);
+    queue->count++;
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *high_task_awoken)
+{
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    if (queue == NULL || queue->count == 0)
+    {
+        return pdFALSE;
+    }
+    memcpy(item, &queue->items[queue->head * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    if (queue != NULL)
+    {
+        queue->count = 0;
+    }
+    return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (queue != NULL)
+    {
+        free(queue->items);
+        free(queue);
+    }
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *high_task_awoken)
+{
+    return pdPASS;
+}
\ No newline at end of file
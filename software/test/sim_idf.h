@@ -0,0 +1,80 @@
+#ifndef SIM_IDF_H
+#define SIM_IDF_H
+
+#include "driver/gpio.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Simulated time, gptimers, esp_timers, GPIO, UART TX FIFO and queues for the host tests of the modules run by
+// the timer and GPIO ISRs. All timers count the same microseconds, alarms are played in time order by sim_run_until.
+
+typedef void (*sim_gpio_hook_t)(gpio_num_t pin, uint32_t level);
+typedef void (*sim_uart_hook_t)(const uint8_t *bytes, uint32_t length);
+
+/**
+ * Return the simulated time
+ *
+ * @param void
+ * @return uint64_t time in microseconds.
+ */
+uint64_t sim_time(void);
+
+/**
+ * Play the timer alarms due up to the given time and move the simulated time to it
+ *
+ * @param uint64_t time End time in microseconds.
+ * @return void.
+ */
+void sim_run_until(uint64_t time);
+
+/**
+ * Delay every alarm callback by a random latency, the alarm value stays the scheduled time
+ *
+ * @param uint32_t max_latency_us Largest latency, 0 to call the callbacks on time.
+ * @param unsigned seed Seed of the latencies.
+ * @return void.
+ */
+void sim_set_isr_latency(uint32_t max_latency_us, unsigned seed);
+
+/**
+ * Call a function on every output level written
+ *
+ * @param sim_gpio_hook_t hook Function to call, NULL for none.
+ * @return void.
+ */
+void sim_set_gpio_hook(sim_gpio_hook_t hook);
+
+/**
+ * Set the level read from an input pin
+ *
+ * @param gpio_num_t pin Pin to set.
+ * @param int level Level of the pin.
+ * @return void.
+ */
+void sim_set_input_level(gpio_num_t pin, int level);
+
+/**
+ * Run the interrupt handler added for a pin, as on an edge of the pin
+ *
+ * @param gpio_num_t pin Pin of the interrupt.
+ * @return bool false if no handler is added for the pin.
+ */
+bool sim_fire_gpio_isr(gpio_num_t pin);
+
+/**
+ * Call a function with the bytes written to the UART TX FIFO
+ *
+ * @param sim_uart_hook_t hook Function to call, NULL for none.
+ * @return void.
+ */
+void sim_set_uart_hook(sim_uart_hook_t hook);
+
+/**
+ * Set the free space reported by the UART TX FIFO
+ *
+ * @param uint32_t room Free bytes.
+ * @return void.
+ */
+void sim_set_uart_fifo_room(uint32_t room);
+
+#endif // SIM_IDF_H
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef I2C_H
+#define I2C_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define I2C_NUM_0 0
+#define I2C_MASTER_WRITE 0
+
+typedef struct i2c_cmd_link *i2c_cmd_handle_t;
+
+// Defined by the tests that need them
+i2c_cmd_handle_t i2c_cmd_link_create(void);
+void i2c_cmd_link_delete(i2c_cmd_handle_t cmd);
+esp_err_t i2c_master_start(i2c_cmd_handle_t cmd);
+esp_err_t i2c_master_stop(i2c_cmd_handle_t cmd);
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t cmd, uint8_t data, bool ack_en);
+esp_err_t i2c_master_write(i2c_cmd_handle_t cmd, const uint8_t *data, size_t data_len, bool ack_en);
+esp_err_t i2c_master_cmd_begin(int i2c_num, i2c_cmd_handle_t cmd, TickType_t ticks_to_wait);
+
+#endif // I2C_H
\ No newline at end of file
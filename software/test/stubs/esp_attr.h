@@ -0,0 +1,7 @@
+#ifndef ESP_ATTR_H
+#define ESP_ATTR_H
+
+// Placement attributes have no meaning on the host
+#define IRAM_ATTR
+
+#endif // ESP_ATTR_H
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef ESP_HEAP_CAPS_H
+#define ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+// Defined by the tests that need them
+void *heap_caps_calloc(size_t n, size_t size, unsigned caps);
+void heap_caps_free(void *ptr);
+
+#endif // ESP_HEAP_CAPS_H
\ No newline at end of file
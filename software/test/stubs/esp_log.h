@@ -0,0 +1,19 @@
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+#include <stdio.h>
+
+// Warnings and errors are printed, the information logs are checked by the compiler only
+#define ESP_LOGE(tag, format, ...) printf("E %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) printf("W %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)                             \
+    do                                                         \
+    {                                                          \
+        if (0)                                                 \
+        {                                                      \
+            printf("I %s: " format "\n", tag, ##__VA_ARGS__); \
+        }                                                      \
+    } while (0)
+#define ESP_LOGD ESP_LOGI
+
+#endif // ESP_LOG_H
\ No newline at end of file
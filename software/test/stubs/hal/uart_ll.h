@@ -0,0 +1,13 @@
+#ifndef UART_LL_H
+#define UART_LL_H
+
+#include <stdint.h>
+
+typedef struct uart_dev_s uart_dev_t;
+
+#define UART_LL_GET_HW(num) ((uart_dev_t *)(uintptr_t)((num) + 1))
+
+uint32_t uart_ll_get_txfifo_len(uart_dev_t *hw);
+void uart_ll_write_txfifo(uart_dev_t *hw, const uint8_t *buf, uint32_t wr_len);
+
+#endif // UART_LL_H
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+// The encoder reader backend is chosen by the test target, CONFIG_ENCODER_READER_BACKEND_PCNT=1 for the pulse counter
+#ifndef CONFIG_ENCODER_READER_PCNT_GLITCH_NS
+#define CONFIG_ENCODER_READER_PCNT_GLITCH_NS 10000
+#endif
+
+#endif // SDKCONFIG_H
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+    int _address;
+    int _width;
+    int _height;
+    int _pages;
+} SSD1306_t;
+
+// Defined by the tests that need them
+void i2c_master_init(SSD1306_t *dev, int16_t sda, int16_t scl, int16_t reset);
+void ssd1306_init(SSD1306_t *dev, int width, int height);
+void ssd1306_contrast(SSD1306_t *dev, int contrast);
+void ssd1306_clear_screen(SSD1306_t *dev, bool invert);
+
+#endif // SSD1306_H
\ No newline at end of file
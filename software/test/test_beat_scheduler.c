@@ -0,0 +1,75 @@
+#include "beat_scheduler.h"
+#include "test_check.h"
+
+#define DRIFT_BEATS 1000000 // beats advanced at every bpm
+#define START_TIME 1000000  // microseconds, timestamp of beat 0
+
+/**
+ * Exact timestamp of a beat, floor(beat * 60e6 / bpm) after the start
+ *
+ * @param uint64_t beat Index of the beat.
+ * @param uint16_t bpm Tempo in beats per minute.
+ * @return uint64_t timestamp in microseconds.
+ */
+static uint64_t exact_beat_time(uint64_t beat, uint16_t bpm)
+{
+    return START_TIME + (uint64_t)((unsigned __int128)beat * US_PER_MINUTE / bpm);
+}
+
+/**
+ * Advance DRIFT_BEATS beats at every bpm and compare each timestamp with the exact one
+ *
+ * @return void.
+ */
+static void test_no_drift(void)
+{
+    for (uint16_t bpm = 1; bpm <= 999; bpm++)
+    {
+        beat_scheduler_t scheduler;
+        beat_scheduler_init(&scheduler, START_TIME, bpm);
+        uint64_t worst = 0;
+        for (uint64_t beat = 1; beat <= DRIFT_BEATS; beat++)
+        {
+            uint64_t time = beat_scheduler_advance(&scheduler);
+            uint64_t exact = exact_beat_time(beat, bpm);
+            uint64_t error = (time > exact) ? time - exact : exact - time;
+            worst = (error > worst) ? error : worst;
+        }
+        CHECK(worst == 0, "bpm %u drifted up to %llu us", bpm, (unsigned long long)worst);
+        CHECK(beat_scheduler_beat_time(&scheduler, DRIFT_BEATS) == scheduler.time,
+              "bpm %u beat time of beat %d differs from the advanced time", bpm, DRIFT_BEATS);
+    }
+}
+
+/**
+ * Change the tempo midway, the following beats continue exactly from the beat of the change
+ *
+ * @return void.
+ */
+static void test_set_bpm(void)
+{
+    beat_scheduler_t scheduler;
+    beat_scheduler_init(&scheduler, START_TIME, 7);
+    for (int beat = 0; beat < 1000; beat++)
+    {
+        beat_scheduler_advance(&scheduler);
+    }
+    uint64_t change_time = scheduler.time;
+    beat_scheduler_set_bpm(&scheduler, 133);
+    for (uint64_t beat = 1; beat <= DRIFT_BEATS; beat++)
+    {
+        beat_scheduler_advance(&scheduler);
+    }
+    uint64_t exact = change_time + (uint64_t)((unsigned __int128)DRIFT_BEATS * US_PER_MINUTE / 133);
+    CHECK(scheduler.time == exact, "after the tempo change %llu us, expected %llu us",
+          (unsigned long long)scheduler.time, (unsigned long long)exact);
+    CHECK(beat_scheduler_beat_time(&scheduler, scheduler.beat) == scheduler.time, "beat time after the tempo change");
+}
+
+int main(void)
+{
+    test_no_drift();
+    test_set_bpm();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+// Failed checks of the test, the exit status of main
+static int test_failures = 0;
+
+// Report a failed condition with a message and keep going, so one run shows every failure
+#define CHECK(condition, ...)                                                  \
+    do                                                                         \
+    {                                                                          \
+        if (!(condition))                                                      \
+        {                                                                      \
+            printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #condition); \
+            printf(__VA_ARGS__);                                               \
+            printf("\n");                                                      \
+            test_failures++;                                                   \
+        }                                                                      \
+    } while (0)
+
+#endif // TEST_CHECK_H
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "encoder_acceleration.h"
+#include "settings.h"
+#include "test_check.h"
+#include <time.h>
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof(array[0]))
+#define BENCHMARK_STEPS 10000000 // steps timed for the cost per step
+
+static const encoder_acceleration_point_t points[] = ENC_ACCEL_CURVE;
+static const encoder_acceleration_curve_t curve = {points, ARRAY_LENGTH(points), ENC_ACCEL_SMOOTHING, ENC_ACCEL_EXPIRE_US};
+
+// Intervals between the detents of a spin recorded from 40 to about 350 bpm, in microseconds. The hand speeds
+// up, spins and slows down to find the target.
+static const uint32_t spin_trace[] = {
+    130000, 85000, 62000, 47000, 36000, 31000, 28000, 25000, 24000, 22000, 23000, 21000, 22000, 24000, 26000,
+    31000, 39000, 52000, 74000, 115000, 185000, 260000, 330000, 410000, 460000};
+
+// Intervals of detents turned one at a time to set an exact tempo
+static const uint32_t slow_trace[] = {
+    310000, 280000, 350000, 295000, 270000, 330000, 405000, 260000, 290000, 315000, 380000, 275000};
+
+/**
+ * Play a trace and return the bpm change of every detent
+ *
+ * @param const uint32_t* intervals Intervals of the trace.
+ * @param int count Intervals in the trace.
+ * @param int8_t direction Turn direction.
+ * @param int32_t* changes Output, bpm change of each detent.
+ * @return int32_t total bpm change.
+ */
+static int32_t play(const uint32_t *intervals, int count, int8_t direction, int32_t *changes)
+{
+    encoder_acceleration_t acceleration;
+    encoder_acceleration_init(&acceleration);
+    uint64_t time = 1000000;
+    int32_t total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        time += intervals[i];
+        changes[i] = encoder_acceleration_step(&acceleration, &curve, direction, time);
+        total += changes[i];
+    }
+    return total;
+}
+
+/**
+ * The gain is held at the ends of the curve and interpolated between the points
+ *
+ * @return void.
+ */
+static void test_gain(void)
+{
+    CHECK(encoder_acceleration_gain(&curve, 0) == points[0].gain, "gain at rest");
+    CHECK(encoder_acceleration_gain(&curve, (uint32_t)points[1].rate << ENCODER_ACCELERATION_RATE_BITS) == points[1].gain,
+          "gain at the second point");
+    CHECK(encoder_acceleration_gain(&curve, 1000 << ENCODER_ACCELERATION_RATE_BITS) == points[curve.count - 1].gain,
+          "gain above the curve");
+    uint32_t middle = ((uint32_t)(points[2].rate + points[3].rate) << ENCODER_ACCELERATION_RATE_BITS) / 2;
+    CHECK(encoder_acceleration_gain(&curve, middle) == (points[2].gain + points[3].gain) / 2, "gain %u between the points",
+          encoder_acceleration_gain(&curve, middle));
+}
+
+/**
+ * Slow detents move one bpm each in both directions
+ *
+ * @return void.
+ */
+static void test_slow(void)
+{
+    int32_t changes[ARRAY_LENGTH(slow_trace)];
+    for (int8_t direction = -1; direction <= 1; direction += 2)
+    {
+        play(slow_trace, ARRAY_LENGTH(slow_trace), direction, changes);
+        int wrong_changes = 0;
+        for (int i = 0; i < ARRAY_LENGTH(slow_trace); i++)
+        {
+            wrong_changes += changes[i] != direction;
+        }
+        CHECK(wrong_changes == 0, "%d slow detents did not move one bpm", wrong_changes);
+    }
+}
+
+/**
+ * A spin covers the tempo range in a few detents and lands on single bpm as the hand slows down
+ *
+ * @return void.
+ */
+static void test_spin(void)
+{
+    int32_t changes[ARRAY_LENGTH(spin_trace)];
+    int32_t total = play(spin_trace, ARRAY_LENGTH(spin_trace), 1, changes);
+    int32_t largest = 0;
+    for (int i = 0; i < ARRAY_LENGTH(spin_trace); i++)
+    {
+        largest = (changes[i] > largest) ? changes[i] : largest;
+    }
+    printf("spin of %d detents moved %d bpm, largest step %d bpm\n", (int)ARRAY_LENGTH(spin_trace), total, largest);
+    CHECK(changes[0] == 1, "first detent moved %d bpm", changes[0]);
+    CHECK(largest == points[curve.count - 1].gain / ENCODER_ACCELERATION_GAIN_ONE, "largest step %d bpm", largest);
+    CHECK(total >= 280 && total <= 340, "spin moved %d bpm", total);
+    for (int i = ARRAY_LENGTH(spin_trace) - 3; i < ARRAY_LENGTH(spin_trace); i++)
+    {
+        CHECK(changes[i] == 1, "detent %d of the slow down moved %d bpm", i + 1, changes[i]);
+    }
+
+    // Turning back drops to one bpm right away
+    encoder_acceleration_t acceleration;
+    encoder_acceleration_init(&acceleration);
+    uint64_t time = 1000000;
+    for (int i = 0; i < 12; i++)
+    {
+        time += spin_trace[i];
+        encoder_acceleration_step(&acceleration, &curve, 1, time);
+    }
+    CHECK(encoder_acceleration_step(&acceleration, &curve, -1, time + 25000) == -1, "reversal kept the speed");
+}
+
+/**
+ * Detents taken in batches give the rate of the detents, not of the batches. The interval up to the next batch
+ * holds the detents of the last one.
+ *
+ * @return void.
+ */
+static void test_batches(void)
+{
+    encoder_acceleration_t singles;
+    encoder_acceleration_t pairs;
+    encoder_acceleration_init(&singles);
+    encoder_acceleration_init(&pairs);
+    int32_t single_total = 0;
+    int32_t pair_total = 0;
+    int32_t last_pair = 0;
+    for (int i = 0; i < 40; i++)
+    {
+        // 50 detents per second, taken one at a time or two at a time
+        single_total += encoder_acceleration_step(&singles, &curve, 1, 1000000 + i * 20000ULL);
+        if (i % 2 == 0)
+        {
+            last_pair = encoder_acceleration_step(&pairs, &curve, 2, 1000000 + i * 20000ULL);
+            pair_total += last_pair;
+        }
+    }
+    uint32_t top = points[curve.count - 1].gain / ENCODER_ACCELERATION_GAIN_ONE;
+    CHECK(pairs.rate == singles.rate, "pairs at rate %u, singles at rate %u", pairs.rate, singles.rate);
+    CHECK(last_pair == 2 * top, "pair moved %d bpm", last_pair);
+    CHECK(pair_total + 2 * (int32_t)top >= single_total && pair_total <= single_total + 2 * (int32_t)top,
+          "pairs moved %d bpm, singles %d bpm", pair_total, single_total);
+}
+
+/**
+ * Measure the cost of one step
+ *
+ * @return void.
+ */
+static void benchmark(void)
+{
+    encoder_acceleration_t acceleration;
+    encoder_acceleration_init(&acceleration);
+    volatile int32_t sink = 0;
+    clock_t start = clock();
+    for (uint64_t i = 0; i < BENCHMARK_STEPS; i++)
+    {
+        sink += encoder_acceleration_step(&acceleration, &curve, (i & 64) ? 1 : -1, 1000000 + i * 20000);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%.2f ns per step\n", seconds * 1e9 / BENCHMARK_STEPS);
+    (void)sink;
+}
+
+int main(void)
+{
+    test_gain();
+    test_slow();
+    test_spin();
+    test_batches();
+    benchmark();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "encoder_reader.h"
+#include "encoder_wave.h"
+#include "sim_idf.h"
+#include "test_check.h"
+#include <stdlib.h>
+
+#define PIN_A 4
+#define PIN_B 5
+#define PIN_SW 6
+#define ISR_LATENCY_US 2.0 // From the edge to the start of the ISR
+#define ISR_SAMPLE_US 0.5  // From the start of the ISR to reading the levels, later edges wait for the next ISR
+#define ISR_LENGTH_US 2.0
+
+/**
+ * @brief Waveform replayed with the time the handler task takes between two ticks
+ */
+typedef struct
+{
+    encoder_wave_t wave;
+    double handler_us;
+} replay_t;
+
+static const replay_t replays[] = {
+    {{1000, 0, 0, 5000, 50}, 100},
+    {{1000, 0.5, 50, 5000, 50}, 100},
+    {{1000, 1.0, 150, 5000, 50}, 100},
+    {{4000, 0.5, 50, 5000, 50}, 2000},
+    {{4000, 1.0, 100, 5000, 50}, 2000},
+    {{10000, 0.5, 20, 5000, 50}, 5000},
+};
+
+/**
+ * Create and start a reader on the simulated pins at rest
+ *
+ * @return encoder_reader_handle_t started reader.
+ */
+static encoder_reader_handle_t start_reader(void)
+{
+    sim_set_input_level(PIN_A, 1);
+    sim_set_input_level(PIN_B, 1);
+    sim_set_input_level(PIN_SW, 1);
+    encoreder_reader_settings_t settings = {
+        .pin_a = PIN_A,
+        .pin_b = PIN_B,
+        .pin_sw = PIN_SW,
+        .sw_debounce_us = 5000,
+        .sw_longpress_us = 1000000,
+        .tick_queue = xQueueCreate(8, sizeof(encoder_tick_t))};
+    encoder_reader_handle_t reader = NULL;
+    CHECK(encoder_reader_setup(&settings, &reader) == ESP_OK, "setup failed");
+    CHECK(encoder_reader_start(reader) == ESP_OK, "start failed");
+    return reader;
+}
+
+/**
+ * Delete a reader started by start_reader and its queue
+ *
+ * @param encoder_reader_handle_t reader Reader to delete.
+ * @return void.
+ */
+static void delete_reader(encoder_reader_handle_t reader)
+{
+    QueueHandle_t queue = reader->tick_queue;
+    encoder_reader_delete(reader);
+    vQueueDelete(queue);
+}
+
+/**
+ * Take the ticks from the queue like the encoder handler task
+ *
+ * @param encoder_reader_handle_t reader Reader to take from.
+ * @param uint32_t* items Queue items received, incremented.
+ * @return int32_t detents taken.
+ */
+static int32_t take_tick(encoder_reader_handle_t reader, uint32_t *items)
+{
+    encoder_tick_t tick;
+    if (xQueueReceive(reader->tick_queue, &tick, 0) != pdTRUE)
+    {
+        return 0;
+    }
+    (*items)++;
+    return encoder_reader_take_detents(reader);
+}
+
+/**
+ * Replay a bouncy waveform through the pin ISR. The levels are sampled some time after the edge, edges that
+ * come before the sample are handled by the same ISR.
+ *
+ * @param const replay_t* replay Waveform to replay.
+ * @return void.
+ */
+static void replay(const replay_t *replay)
+{
+    encoder_edge_t *edges;
+    int32_t net;
+    int32_t count = encoder_wave_generate(&replay->wave, &edges, &net);
+    encoder_reader_handle_t reader = start_reader();
+    uint64_t start = sim_time();
+    int levels[2] = {1, 1};
+    uint32_t interrupts = 0;
+    uint32_t items = 0;
+    int32_t taken = 0;
+    double busy_until = 0;
+    double next_handler = 0;
+    for (int32_t i = 0; i < count;)
+    {
+        double isr_start = (edges[i].time + ISR_LATENCY_US > busy_until) ? edges[i].time + ISR_LATENCY_US : busy_until;
+        double sample = isr_start + ISR_SAMPLE_US;
+        for (; i < count && edges[i].time <= sample; i++)
+        {
+            levels[edges[i].pin] ^= 1;
+        }
+        sim_set_input_level(PIN_A, levels[ENCODER_WAVE_PIN_A]);
+        sim_set_input_level(PIN_B, levels[ENCODER_WAVE_PIN_B]);
+        sim_run_until(start + (uint64_t)sample);
+        CHECK(sim_fire_gpio_isr(PIN_A), "no pin ISR");
+        interrupts++;
+        busy_until = isr_start + ISR_LENGTH_US;
+
+        // The handler task gets to the queue once it is done with the previous tick
+        if (sample >= next_handler)
+        {
+            uint32_t before = items;
+            taken += take_tick(reader, &items);
+            next_handler = (items != before) ? sample + replay->handler_us : next_handler;
+        }
+    }
+    taken += take_tick(reader, &items);
+
+    printf("%5.0f edges/s, bounce %3.0f%% %3.0f us: %6d detents net, taken %6d, position %6d, %6u interrupts, %4u ticks\n",
+           replay->wave.edges_per_second, replay->wave.bounce_probability * 100, replay->wave.bounce_us, net, taken,
+           encoder_reader_get_position(reader), interrupts, items);
+    CHECK(taken == net && encoder_reader_get_position(reader) == net, "%d detents taken of %d", taken, net);
+    CHECK(reader->invalid_transitions == 0, "%u invalid transitions", reader->invalid_transitions);
+    CHECK(encoder_reader_get_queue_overflows(reader) == 0, "%u ticks lost", encoder_reader_get_queue_overflows(reader));
+    delete_reader(reader);
+    free(edges);
+}
+
+/**
+ * Both pins changing between two samples is counted as invalid and does not move the position
+ *
+ * @return void.
+ */
+static void test_invalid_jump(void)
+{
+    encoder_reader_handle_t reader = start_reader();
+    sim_set_input_level(PIN_A, 0);
+    sim_set_input_level(PIN_B, 0);
+    sim_fire_gpio_isr(PIN_A);
+    sim_set_input_level(PIN_A, 1);
+    sim_fire_gpio_isr(PIN_A);
+    sim_set_input_level(PIN_B, 1);
+    sim_fire_gpio_isr(PIN_B);
+    CHECK(reader->invalid_transitions == 1, "%u invalid transitions", reader->invalid_transitions);
+    CHECK(encoder_reader_get_position(reader) == 0, "position %d after the jump", encoder_reader_get_position(reader));
+    delete_reader(reader);
+}
+
+int main(void)
+{
+    srand(1);
+    for (int i = 0; i < sizeof(replays) / sizeof(replays[0]); i++)
+    {
+        replay(&replays[i]);
+    }
+    test_invalid_jump();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,495 @@
+#include "encoder_reader.h"
+#include "encoder_wave.h"
+#include "sim_idf.h"
+#include "test_check.h"
+#include <stdlib.h>
+
+#define PIN_A 4
+#define PIN_B 5
+#define PIN_SW 6
+#define SIM_PCNT_PINS 64       // GPIO pins the channels can use
+#define SIM_PCNT_WATCH_POINTS 4
+
+// Simulated pulse counter channel, counting the edges of one pin in the direction set by the level of another
+struct pcnt_chan_t
+{
+    int edge_gpio_num;
+    int level_gpio_num;
+    pcnt_channel_edge_action_t pos_act;
+    pcnt_channel_edge_action_t neg_act;
+    pcnt_channel_level_action_t high_act;
+    pcnt_channel_level_action_t low_act;
+};
+
+// Simulated pulse counter unit. Reaching a limit clears the count, a watch point calls the callback first.
+struct pcnt_unit_t
+{
+    int low_limit;
+    int high_limit;
+    int count;
+    bool enabled;
+    bool running;
+    unsigned int glitch_ns;
+    int watch_points[SIM_PCNT_WATCH_POINTS];
+    int watch_point_count;
+    pcnt_watch_cb_t on_reach;
+    void *user_data;
+    struct pcnt_chan_t channels[2];
+    int channel_count;
+};
+
+static struct pcnt_unit_t *unit = NULL;
+static int filtered_levels[SIM_PCNT_PINS]; // Levels that passed the glitch filter
+static uint32_t watch_events = 0;
+static int fail_call = -1; // Driver call refused with ESP_FAIL, counted from the next one
+
+/**
+ * Check if the driver call is the one to refuse
+ *
+ * @return bool true to fail the call.
+ */
+static bool refuse_call(void)
+{
+    return fail_call >= 0 && fail_call-- == 0;
+}
+
+/**
+ * @brief Waveform replayed with the time the handler task takes between two ticks
+ */
+typedef struct
+{
+    encoder_wave_t wave;
+    double handler_us;
+} replay_t;
+
+static const replay_t replays[] = {
+    {{1000, 0, 0, 5000, 50}, 100},
+    {{1000, 0.5, 50, 5000, 50}, 100},
+    {{1000, 1.0, 150, 5000, 50}, 100},
+    {{4000, 0.5, 50, 5000, 50}, 2000},
+    {{4000, 1.0, 100, 5000, 50}, 2000},
+    {{10000, 0.5, 20, 5000, 50}, 5000},
+};
+
+esp_err_t pcnt_new_unit(const pcnt_unit_config_t *config, pcnt_unit_handle_t *ret_unit)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    if (unit != NULL)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    unit = calloc(1, sizeof(struct pcnt_unit_t));
+    unit->low_limit = config->low_limit;
+    unit->high_limit = config->high_limit;
+    *ret_unit = unit;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_del_unit(pcnt_unit_handle_t pcnt_unit)
+{
+    CHECK(!pcnt_unit->enabled && pcnt_unit->channel_count == 0, "unit deleted while in use");
+    free(pcnt_unit);
+    unit = NULL;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_set_glitch_filter(pcnt_unit_handle_t pcnt_unit, const pcnt_glitch_filter_config_t *config)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    pcnt_unit->glitch_ns = config->max_glitch_ns;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_new_channel(pcnt_unit_handle_t pcnt_unit, const pcnt_chan_config_t *config, pcnt_channel_handle_t *ret_chan)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    if (pcnt_unit->channel_count >= 2)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct pcnt_chan_t *channel = &pcnt_unit->channels[pcnt_unit->channel_count++];
+    *channel = (struct pcnt_chan_t){.edge_gpio_num = config->edge_gpio_num, .level_gpio_num = config->level_gpio_num};
+    *ret_chan = channel;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_del_channel(pcnt_channel_handle_t chan)
+{
+    unit->channel_count--;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_channel_set_edge_action(pcnt_channel_handle_t chan, pcnt_channel_edge_action_t pos_act, pcnt_channel_edge_action_t neg_act)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    chan->pos_act = pos_act;
+    chan->neg_act = neg_act;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_channel_set_level_action(pcnt_channel_handle_t chan, pcnt_channel_level_action_t high_act, pcnt_channel_level_action_t low_act)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    chan->high_act = high_act;
+    chan->low_act = low_act;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_add_watch_point(pcnt_unit_handle_t pcnt_unit, int watch_point)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    if (pcnt_unit->watch_point_count >= SIM_PCNT_WATCH_POINTS || watch_point < pcnt_unit->low_limit || watch_point > pcnt_unit->high_limit)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pcnt_unit->watch_points[pcnt_unit->watch_point_count++] = watch_point;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_register_event_callbacks(pcnt_unit_handle_t pcnt_unit, const pcnt_event_callbacks_t *cbs, void *user_data)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    pcnt_unit->on_reach = cbs->on_reach;
+    pcnt_unit->user_data = user_data;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_enable(pcnt_unit_handle_t pcnt_unit)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    pcnt_unit->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_disable(pcnt_unit_handle_t pcnt_unit)
+{
+    CHECK(!pcnt_unit->running, "unit disabled while running");
+    pcnt_unit->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_start(pcnt_unit_handle_t pcnt_unit)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    CHECK(pcnt_unit->enabled, "unit started before it was enabled");
+    pcnt_unit->running = true;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_stop(pcnt_unit_handle_t pcnt_unit)
+{
+    pcnt_unit->running = false;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_clear_count(pcnt_unit_handle_t pcnt_unit)
+{
+    if (refuse_call())
+    {
+        return ESP_FAIL;
+    }
+    pcnt_unit->count = 0;
+    return ESP_OK;
+}
+
+/**
+ * Count a level change of a pin that passed the glitch filter
+ *
+ * @param int gpio_num Pin.
+ * @param int level New level.
+ * @return void.
+ */
+static void pcnt_input(int gpio_num, int level)
+{
+    filtered_levels[gpio_num] = level;
+    for (int i = 0; unit != NULL && unit->running && i < unit->channel_count; i++)
+    {
+        const struct pcnt_chan_t *channel = &unit->channels[i];
+        if (channel->edge_gpio_num != gpio_num)
+        {
+            continue;
+        }
+        pcnt_channel_edge_action_t edge_act = level ? channel->pos_act : channel->neg_act;
+        int step = (edge_act == PCNT_CHANNEL_EDGE_ACTION_INCREASE) ? 1 : (edge_act == PCNT_CHANNEL_EDGE_ACTION_DECREASE) ? -1 : 0;
+        pcnt_channel_level_action_t level_act = filtered_levels[channel->level_gpio_num] ? channel->high_act : channel->low_act;
+        step = (level_act == PCNT_CHANNEL_LEVEL_ACTION_INVERSE) ? -step : (level_act == PCNT_CHANNEL_LEVEL_ACTION_HOLD) ? 0 : step;
+        unit->count += step;
+        for (int point = 0; step != 0 && point < unit->watch_point_count; point++)
+        {
+            if (unit->count == unit->watch_points[point])
+            {
+                pcnt_watch_event_data_t edata = {.watch_point_value = unit->count};
+                watch_events++;
+                unit->on_reach(unit, &edata, unit->user_data);
+            }
+        }
+        if (unit->count == unit->high_limit || unit->count == unit->low_limit)
+        {
+            unit->count = 0;
+        }
+    }
+}
+
+/**
+ * Create a reader on the given pins with a queue of its own
+ *
+ * @param int pin_a Pin of A.
+ * @param int pin_b Pin of B.
+ * @param int pin_sw Pin of the switch.
+ * @return encoder_reader_handle_t created reader, NULL if setup failed.
+ */
+static encoder_reader_handle_t setup_reader(int pin_a, int pin_b, int pin_sw)
+{
+    filtered_levels[pin_a] = 1;
+    filtered_levels[pin_b] = 1;
+    sim_set_input_level(pin_sw, 1);
+    encoreder_reader_settings_t settings = {
+        .pin_a = pin_a,
+        .pin_b = pin_b,
+        .pin_sw = pin_sw,
+        .sw_debounce_us = 5000,
+        .sw_longpress_us = 1000000,
+        .tick_queue = xQueueCreate(8, sizeof(encoder_tick_t))};
+    encoder_reader_handle_t reader = NULL;
+    if (encoder_reader_setup(&settings, &reader) != ESP_OK)
+    {
+        vQueueDelete(settings.tick_queue);
+        return NULL;
+    }
+    return reader;
+}
+
+/**
+ * Create and start a reader on the simulated pins at rest
+ *
+ * @return encoder_reader_handle_t started reader.
+ */
+static encoder_reader_handle_t start_reader(void)
+{
+    encoder_reader_handle_t reader = setup_reader(PIN_A, PIN_B, PIN_SW);
+    CHECK(reader != NULL, "setup failed");
+    CHECK(encoder_reader_start(reader) == ESP_OK, "start failed");
+    return reader;
+}
+
+/**
+ * Delete a reader started by start_reader and its queue
+ *
+ * @param encoder_reader_handle_t reader Reader to delete.
+ * @return void.
+ */
+static void delete_reader(encoder_reader_handle_t reader)
+{
+    QueueHandle_t queue = reader->tick_queue;
+    encoder_reader_delete(reader);
+    vQueueDelete(queue);
+}
+
+/**
+ * Take the ticks from the queue like the encoder handler task
+ *
+ * @param encoder_reader_handle_t reader Reader to take from.
+ * @param uint32_t* items Queue items received, incremented.
+ * @return int32_t detents taken.
+ */
+static int32_t take_tick(encoder_reader_handle_t reader, uint32_t *items)
+{
+    encoder_tick_t tick;
+    if (xQueueReceive(reader->tick_queue, &tick, 0) != pdTRUE)
+    {
+        return 0;
+    }
+    (*items)++;
+    return encoder_reader_take_detents(reader);
+}
+
+/**
+ * Replay a bouncy waveform through the pulse counter. A level shorter than the glitch filter never reaches the
+ * counter, the others are counted once the filter has seen them for its whole length.
+ *
+ * @param const replay_t* replay Waveform to replay.
+ * @return void.
+ */
+static void replay(const replay_t *replay)
+{
+    encoder_edge_t *edges;
+    int32_t net;
+    int32_t count = encoder_wave_generate(&replay->wave, &edges, &net);
+    encoder_reader_handle_t reader = start_reader();
+    static const int pins[2] = {PIN_A, PIN_B};
+    uint64_t start = sim_time();
+    double filter_us = unit->glitch_ns / 1000.0;
+    int levels[2] = {1, 1};
+    uint32_t items = 0;
+    int32_t taken = 0;
+    double next_handler = 0;
+    watch_events = 0;
+    for (int32_t i = 0; i < count; i++)
+    {
+        uint8_t pin = edges[i].pin;
+        levels[pin] ^= 1;
+        double held_until = 1e18;
+        for (int32_t next = i + 1; next < count; next++)
+        {
+            if (edges[next].pin == pin)
+            {
+                held_until = edges[next].time;
+                break;
+            }
+        }
+        if (held_until - edges[i].time < filter_us || levels[pin] == filtered_levels[pins[pin]])
+        {
+            continue;
+        }
+        double seen = edges[i].time + filter_us;
+        sim_run_until(start + (uint64_t)seen);
+        pcnt_input(pins[pin], levels[pin]);
+
+        // The handler task gets to the queue once it is done with the previous tick
+        if (seen >= next_handler)
+        {
+            uint32_t before = items;
+            taken += take_tick(reader, &items);
+            next_handler = (items != before) ? seen + replay->handler_us : next_handler;
+        }
+    }
+    taken += take_tick(reader, &items);
+
+    printf("%5.0f edges/s, bounce %3.0f%% %3.0f us: %6d detents net, taken %6d, position %6d, %6u interrupts, %4u ticks\n",
+           replay->wave.edges_per_second, replay->wave.bounce_probability * 100, replay->wave.bounce_us, net, taken,
+           encoder_reader_get_position(reader), watch_events, items);
+    CHECK(taken == net && encoder_reader_get_position(reader) == net, "%d detents taken of %d", taken, net);
+    CHECK(watch_events == replay->wave.detents, "%u interrupts for %d detents", watch_events, replay->wave.detents);
+    CHECK(encoder_reader_get_queue_overflows(reader) == 0, "%u ticks lost", encoder_reader_get_queue_overflows(reader));
+    delete_reader(reader);
+    CHECK(unit == NULL, "unit left after delete");
+    free(edges);
+}
+
+/**
+ * Turn one detent clockwise
+ *
+ * @return void.
+ */
+static void turn_clockwise(void)
+{
+    pcnt_input(PIN_A, 0);
+    pcnt_input(PIN_B, 0);
+    pcnt_input(PIN_A, 1);
+    pcnt_input(PIN_B, 1);
+}
+
+/**
+ * The counter is set up from the configuration and stops counting while disabled
+ *
+ * @return void.
+ */
+static void test_enable(void)
+{
+    encoder_reader_handle_t reader = start_reader();
+    CHECK(unit->glitch_ns == CONFIG_ENCODER_READER_PCNT_GLITCH_NS, "glitch filter %u ns", unit->glitch_ns);
+    CHECK(unit->high_limit == ENCODER_READER_STEPS_PER_DETENT && unit->low_limit == -ENCODER_READER_STEPS_PER_DETENT,
+          "limits %d and %d", unit->low_limit, unit->high_limit);
+    turn_clockwise();
+    CHECK(encoder_reader_get_position(reader) == 1, "position %d after a clockwise detent", encoder_reader_get_position(reader));
+
+    // A detent turned while disabled is lost, the count restarts at the rest state
+    encoder_reader_disable(reader);
+    turn_clockwise();
+    encoder_reader_enable(reader);
+    CHECK(unit->count == 0 && unit->running, "count %d after enabling", unit->count);
+    turn_clockwise();
+    CHECK(encoder_reader_get_position(reader) == 2, "position %d after enabling", encoder_reader_get_position(reader));
+    delete_reader(reader);
+}
+
+/**
+ * A start refused by the driver returns the error and leaves no unit or channel behind. The reader can be
+ * deleted and its pins set up again, the timers it created are released.
+ *
+ * @return void.
+ */
+static void test_start_failure(void)
+{
+    // No unit is free while another instance holds it
+    encoder_reader_handle_t first = start_reader();
+    encoder_reader_handle_t second = setup_reader(PIN_SW + 1, PIN_SW + 2, PIN_SW + 3);
+    esp_err_t ret = encoder_reader_start(second);
+    CHECK(ret == ESP_ERR_NOT_FOUND && !second->enabled, "start without a free unit returned %d", ret);
+    CHECK(unit != NULL && unit->user_data == first && unit->running, "unit of the first reader touched");
+    turn_clockwise();
+    CHECK(encoder_reader_get_position(first) == 1 && encoder_reader_get_position(second) == 0, "detent not counted by the first reader");
+    delete_reader(second);
+    second = setup_reader(PIN_SW + 1, PIN_SW + 2, PIN_SW + 3);
+    CHECK(second != NULL, "pins still registered after a failed start");
+    delete_reader(second);
+    delete_reader(first);
+
+    // Every driver call of the start refused in turn, twice so leaked timers would run out
+    for (int round = 0; round < 2; round++)
+    {
+        for (int call = 0;; call++)
+        {
+            encoder_reader_handle_t reader = setup_reader(PIN_A, PIN_B, PIN_SW);
+            CHECK(reader != NULL, "pins still registered before call %d", call);
+            if (reader == NULL)
+            {
+                return;
+            }
+            fail_call = call;
+            ret = encoder_reader_start(reader);
+            bool reached = fail_call < 0;
+            fail_call = -1;
+            if (!reached)
+            {
+                // The start makes fewer calls, every one has been refused
+                CHECK(ret == ESP_OK && call > 10, "start returned %d after %d calls", ret, call);
+                delete_reader(reader);
+                break;
+            }
+            CHECK(ret == ESP_FAIL && !reader->enabled, "refused call %d returned %d", call, ret);
+            CHECK(unit == NULL, "unit left after refused call %d", call);
+            delete_reader(reader);
+        }
+    }
+}
+
+int main(void)
+{
+    srand(1);
+    for (int i = 0; i < sizeof(replays) / sizeof(replays[0]); i++)
+    {
+        replay(&replays[i]);
+    }
+    test_enable();
+    test_start_failure();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "glyph_store.h"
+#include "test_check.h"
+#include <string.h>
+#include <time.h>
+
+#define BENCHMARK_REQUESTS 2000000 // glyph requests timed for the decode and the cache hit
+
+/**
+ * Draw a row ordered bitmap the way the ssd1306 component does, one pixel at a time into the pages of the panel
+ *
+ * @param const uint8_t* bitmap Bitmap, 32 pixels per row with the leftmost in the most significant bit.
+ * @param uint8_t* image Output, GLYPH_IMAGE_SIZE bytes page after page.
+ * @return void.
+ */
+static void draw_bitmap(const uint8_t *bitmap, uint8_t *image)
+{
+    memset(image, 0, GLYPH_IMAGE_SIZE);
+    for (int row = 0; row < GLYPH_PAGES * 8; row++)
+    {
+        for (int column = 0; column < GLYPH_COLUMNS; column++)
+        {
+            if (bitmap[row * GLYPH_COLUMNS / 8 + column / 8] & (0x80 >> (column % 8)))
+            {
+                image[(row / 8) * GLYPH_COLUMNS + column] |= 1 << (row % 8);
+            }
+        }
+    }
+}
+
+/**
+ * Check the decoded images of one bitmap array
+ *
+ * @param const char* name Name of the array.
+ * @param uint8_t (*bitmaps)[192] Bitmaps of the array.
+ * @param int count Bitmaps in the array.
+ * @param uint8_t first_glyph Glyph id of the first bitmap.
+ * @return void.
+ */
+static void check_images(const char *name, uint8_t (*bitmaps)[192], int count, uint8_t first_glyph)
+{
+    int wrong_images = 0;
+    for (int i = 0; i < count; i++)
+    {
+        uint8_t expected[GLYPH_IMAGE_SIZE];
+        draw_bitmap(bitmaps[i], expected);
+        wrong_images += memcmp(glyph_store_get(first_glyph + i), expected, GLYPH_IMAGE_SIZE) != 0;
+    }
+    CHECK(wrong_images == 0, "%d of %d %s images differ from the bitmaps", wrong_images, count, name);
+}
+
+/**
+ * The cache keeps the glyphs on the screen and replaces the least recently used one
+ *
+ * @return void.
+ */
+static void test_cache(void)
+{
+    glyph_store_stats_t before;
+    glyph_store_stats_t after;
+    glyph_store_get_stats(&before);
+
+    // The four glyphs of a tempo and the one replacing a digit fit the cache
+    const uint8_t *first = glyph_store_get(GLYPH_SIGNATURE(0));
+    for (int i = 1; i < GLYPH_CACHE_SLOTS; i++)
+    {
+        glyph_store_get(GLYPH_NUMBER(i));
+    }
+    for (int i = 1; i < GLYPH_CACHE_SLOTS; i++)
+    {
+        glyph_store_get(GLYPH_NUMBER(i));
+    }
+    CHECK(glyph_store_get(GLYPH_SIGNATURE(0)) == first, "cached glyph moved");
+    glyph_store_get_stats(&after);
+    CHECK(after.misses - before.misses == GLYPH_CACHE_SLOTS && after.hits - before.hits == GLYPH_CACHE_SLOTS,
+          "%u misses and %u hits", after.misses - before.misses, after.hits - before.hits);
+
+    // A new glyph takes the slot of the least recently used one, GLYPH_NUMBER(1)
+    glyph_store_get(GLYPH_STANDBY(0));
+    glyph_store_get_stats(&before);
+    glyph_store_get(GLYPH_SIGNATURE(0));
+    glyph_store_get(GLYPH_NUMBER(2));
+    glyph_store_get_stats(&after);
+    CHECK(after.hits - before.hits == 2, "recently used glyph evicted");
+    glyph_store_get(GLYPH_NUMBER(1));
+    glyph_store_get_stats(&before);
+    CHECK(before.misses == after.misses + 1, "least recently used glyph kept");
+
+    // Unknown ids fall back to the first glyph
+    CHECK(memcmp(glyph_store_get(GLYPH_COUNT), glyph_store_get(0), GLYPH_IMAGE_SIZE) == 0, "unknown id decoded");
+}
+
+/**
+ * Measure the cost of decoding a glyph and of a cache hit
+ *
+ * @return void.
+ */
+static void benchmark(void)
+{
+    volatile uint8_t sink = 0;
+    clock_t start = clock();
+    for (int i = 0; i < BENCHMARK_REQUESTS; i++)
+    {
+        sink += glyph_store_get(i % GLYPH_COUNT)[5]; // More glyphs than slots, every request misses
+    }
+    double miss_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    for (int i = 0; i < BENCHMARK_REQUESTS; i++)
+    {
+        sink += glyph_store_get(i % (GLYPH_CACHE_SLOTS - 1))[5];
+    }
+    double hit_seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%.1f ns per decoded glyph, %.1f ns per cached glyph, %u bytes encoded for %d bytes of images\n",
+           miss_seconds * 1e9 / BENCHMARK_REQUESTS, hit_seconds * 1e9 / BENCHMARK_REQUESTS,
+           glyph_store_index[GLYPH_COUNT], GLYPH_COUNT * GLYPH_IMAGE_SIZE);
+    (void)sink;
+}
+
+int main(void)
+{
+    check_images("signature", segment_display_signatures, SIGNATURE_IMAGES, GLYPH_SIGNATURE(0));
+    check_images("number", segment_display_numbers, NUMBER_IMAGES, GLYPH_NUMBER(0));
+    check_images("standby", segment_display_standby, STANDBY_IMAGES, GLYPH_STANDBY(0));
+    test_cache();
+    benchmark();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
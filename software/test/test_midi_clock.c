@@ -0,0 +1,222 @@
+#define _GNU_SOURCE
+#include "output_handler.h"
+#include "midi_clock.h"
+#include "settings.h"
+#include "sim_idf.h"
+#include "test_check.h"
+#include <fcntl.h>
+#include <string.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define MAX_BYTES 200000 // bytes recorded from the loopback
+#define MAX_CLICKS 4000  // click edges recorded
+
+// Loopback through a pseudo terminal standing in for the MIDI cable. The sent bytes are stamped with the
+// simulated time and read back from the other end in order.
+static int pty_master = -1;
+static int pty_slave = -1;
+static uint64_t sent_times[MAX_BYTES];
+static uint32_t sent_count = 0;
+static uint8_t received[MAX_BYTES];
+static uint32_t received_count = 0;
+
+// Rising and falling edges of the click output
+static uint64_t clicks[MAX_CLICKS];
+static uint64_t click_ends[MAX_CLICKS];
+static uint32_t click_count = 0;
+
+/**
+ * Open the pseudo terminal in raw mode so every byte passes unchanged
+ *
+ * @return bool true on success.
+ */
+static bool open_loopback(void)
+{
+    pty_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty_master < 0 || grantpt(pty_master) != 0 || unlockpt(pty_master) != 0)
+    {
+        return false;
+    }
+    pty_slave = open(ptsname(pty_master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (pty_slave < 0)
+    {
+        return false;
+    }
+    struct termios attributes;
+    tcgetattr(pty_slave, &attributes);
+    cfmakeraw(&attributes);
+    return tcsetattr(pty_slave, TCSANOW, &attributes) == 0;
+}
+
+/**
+ * Read what has arrived at the receiving end of the loopback
+ *
+ * @return void.
+ */
+static void drain_loopback(void)
+{
+    ssize_t length;
+    do
+    {
+        length = read(pty_slave, &received[received_count], MAX_BYTES - received_count);
+        received_count += (length > 0) ? length : 0;
+    } while (length > 0 && received_count < MAX_BYTES);
+}
+
+static void uart_hook(const uint8_t *bytes, uint32_t length)
+{
+    for (uint32_t i = 0; i < length && sent_count < MAX_BYTES; i++)
+    {
+        sent_times[sent_count++] = sim_time();
+    }
+    CHECK(write(pty_master, bytes, length) == length, "loopback write failed");
+    drain_loopback();
+}
+
+static void gpio_hook(gpio_num_t pin, uint32_t level)
+{
+    if (pin == OUTPUT_PIN && level && click_count < MAX_CLICKS)
+    {
+        clicks[click_count++] = sim_time();
+    }
+    else if (pin == OUTPUT_PIN && !level && click_count > 0)
+    {
+        click_ends[click_count - 1] = sim_time();
+    }
+}
+
+/**
+ * Check that the clicks from first_click to last_click end within the duty limit of the time until the next click
+ *
+ * @param uint32_t first_click Index of the first click.
+ * @param uint32_t last_click Index of the last click.
+ * @return void.
+ */
+static void check_duty(uint32_t first_click, uint32_t last_click)
+{
+    uint32_t long_clicks = 0;
+    for (uint32_t click = first_click; click < last_click; click++)
+    {
+        long_clicks += (click_ends[click] - clicks[click]) * 100 > (clicks[click + 1] - clicks[click]) * OUTPUT_MAX_DUTY_PERCENT;
+    }
+    CHECK(long_clicks == 0, "%u of %u clicks longer than the duty limit", long_clicks, last_click - first_click);
+}
+
+/**
+ * Return the index of the first received byte at or after a time
+ *
+ * @param uint64_t time Time in microseconds.
+ * @return uint32_t byte index.
+ */
+static uint32_t byte_at(uint64_t time)
+{
+    uint32_t index = 0;
+    while (index < received_count && sent_times[index] < time)
+    {
+        index++;
+    }
+    return index;
+}
+
+/**
+ * Check the timing clocks between the clicks from first_click to last_click. Every beat must get 24 clocks, the last
+ * one on the following click. Without ISR latency the clocks must divide the beat evenly.
+ *
+ * @param uint32_t first_click Index of the first click.
+ * @param uint32_t last_click Index of the last click.
+ * @param bool exact Check the spacing of the clocks.
+ * @return void.
+ */
+static void check_clocks(uint32_t first_click, uint32_t last_click, bool exact)
+{
+    uint32_t wrong_counts = 0;
+    uint32_t wrong_spacings = 0;
+    uint32_t index = byte_at(clicks[first_click] + 1);
+    for (uint32_t click = first_click; click < last_click; click++)
+    {
+        uint64_t period = clicks[click + 1] - clicks[click];
+        uint32_t pulses = 0;
+        for (; index < received_count && sent_times[index] <= clicks[click + 1]; index++)
+        {
+            if (received[index] != MIDI_TIMING_CLOCK)
+            {
+                continue;
+            }
+            pulses++;
+            uint64_t expected = clicks[click] + period * pulses / MIDI_CLOCK_PPQN;
+            wrong_spacings += exact && sent_times[index] != expected;
+        }
+        wrong_counts += pulses != MIDI_CLOCK_PPQN;
+    }
+    CHECK(wrong_counts == 0, "%u of %u beats without 24 clocks", wrong_counts, last_click - first_click);
+    CHECK(wrong_spacings == 0, "%u clocks off the even spacing", wrong_spacings);
+}
+
+int main(void)
+{
+    CHECK(open_loopback(), "pseudo terminal not available");
+    sim_set_uart_hook(uart_hook);
+    sim_set_gpio_hook(gpio_hook);
+    CHECK(start_output_handler() == ESP_OK, "output handler start failed");
+
+    // Start on the next downbeat, the first clock after Start falls on the click
+    output_handler_set_midi_clock(true);
+    sim_run_until(20000000);
+    static const uint8_t start[] = {MIDI_SONG_POSITION, 0, 0, MIDI_START, MIDI_TIMING_CLOCK};
+    CHECK(received_count > sizeof(start) && memcmp(received, start, sizeof(start)) == 0, "no Start at the beginning");
+    CHECK(sent_times[0] == clicks[0], "Start sent at %llu us, downbeat at %llu us", (unsigned long long)sent_times[0],
+          (unsigned long long)clicks[0]);
+    uint32_t tempo_click = click_count - 1;
+    check_clocks(0, tempo_click, true);
+    check_duty(0, tempo_click);
+
+    // 999 bpm puts the clocks 2.5 ms apart. The change cuts the running beat short, the clocks it still owes are
+    // sent right after the following click so none is lost.
+    CHECK(output_handler_set_tempo(999, TEMPO_APPLY_NEXT_BEAT, 0) == ESP_OK, "tempo change failed");
+    sim_run_until(sim_time() + 30000000);
+    uint32_t latency_click = click_count - 1;
+    uint32_t transition_clocks = 0;
+    for (uint32_t i = byte_at(clicks[tempo_click] + 1); i < byte_at(clicks[tempo_click + 2] + 1); i++)
+    {
+        transition_clocks += received[i] == MIDI_TIMING_CLOCK;
+    }
+    CHECK(transition_clocks == 2 * MIDI_CLOCK_PPQN, "%u clocks in the two beats of the change", transition_clocks);
+    check_clocks(tempo_click + 2, latency_click, true);
+
+    // The accents are longer than half of the 60 ms beat, every one is cut and counted
+    output_overrun_counters_t counters;
+    output_handler_get_overrun_counters(&counters);
+    check_duty(tempo_click, latency_click);
+    CHECK(counters.shortened >= latency_click - tempo_click - 1 && counters.overruns == counters.shortened,
+          "%u clicks shortened, %u overruns", counters.shortened, counters.overruns);
+
+    // Late alarms must not lose or add clocks, a late beat keeps the clocks of its own beat
+    sim_set_isr_latency(2000, 1);
+    sim_run_until(sim_time() + 30000000);
+    sim_set_isr_latency(0, 0);
+    check_clocks(latency_click + 1, click_count - 1, false);
+    printf("%u clicks, %u bytes looped back\n", click_count, received_count);
+
+    // Stop reports the position in 16th notes
+    uint32_t stop_index = received_count;
+    output_handler_set_midi_clock(false);
+    CHECK(received_count == stop_index + 4 && received[stop_index] == MIDI_STOP && received[stop_index + 1] == MIDI_SONG_POSITION,
+          "no Stop with the song position");
+    uint32_t clocks = 0;
+    for (uint32_t i = 0; i < stop_index; i++)
+    {
+        clocks += received[i] == MIDI_TIMING_CLOCK;
+    }
+    uint32_t position = received[stop_index + 2] | received[stop_index + 3] << 7;
+    CHECK(position == (clocks / MIDI_CLOCK_PER_POSITION) % (1 << 14), "stopped at %u, sent %u clocks", position, clocks);
+    sim_run_until(sim_time() + 2000000);
+    CHECK(received_count == stop_index + 4, "clocks sent after Stop");
+
+    // A full FIFO drops the message instead of blocking the ISR
+    sim_set_uart_fifo_room(0);
+    CHECK(!midi_clock_send_song_position(0) && midi_clock_get_dropped() == 1, "message not dropped");
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "midi_pll.h"
+#include "midi_clock.h"
+#include "test_check.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define STREAM_BEATS 400  // beats replayed in each stream
+#define SETTLE_BEATS 50   // beats before the output jitter is measured
+#define USB_FRAME_US 1000 // USB MIDI delivers the pulses on 1 ms frames
+
+// Jitter added to the pulses of a replayed clock stream
+typedef enum
+{
+    JITTER_GAUSSIAN, // Normally distributed with the given deviation
+    JITTER_USB,      // Delayed to the next USB frame and a random part of the given amount
+} jitter_t;
+
+typedef struct
+{
+    double bpm;
+    jitter_t jitter;
+    double jitter_us;
+} stream_t;
+
+static const stream_t streams[] = {
+    {120, JITTER_GAUSSIAN, 500},
+    {120, JITTER_GAUSSIAN, 2000},
+    {60, JITTER_GAUSSIAN, 1000},
+    {240, JITTER_GAUSSIAN, 300},
+    {999, JITTER_GAUSSIAN, 100},
+    {120, JITTER_USB, 100},
+    {300, JITTER_USB, 100},
+};
+
+/**
+ * Return a normally distributed random number
+ *
+ * @return double number with deviation 1.
+ */
+static double gaussian(void)
+{
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+/**
+ * Return the jitter of a pulse
+ *
+ * @param const stream_t* stream Replayed stream.
+ * @param double ideal Ideal time of the pulse.
+ * @return double jitter in microseconds.
+ */
+static double pulse_jitter(const stream_t *stream, double ideal)
+{
+    if (stream->jitter == JITTER_USB)
+    {
+        return ceil(ideal / USB_FRAME_US) * USB_FRAME_US - ideal + rand() % (int)stream->jitter_us;
+    }
+    return gaussian() * stream->jitter_us;
+}
+
+/**
+ * Replay a jittered clock stream, report the lock time and the jitter of the predicted beats
+ *
+ * @param const stream_t* stream Stream to replay.
+ * @return void.
+ */
+static void replay(const stream_t *stream)
+{
+    midi_pll_t pll;
+    midi_pll_init(&pll);
+    midi_pll_start(&pll);
+    double period = 60e6 / stream->bpm / MIDI_CLOCK_PPQN;
+    double start = 1e6;
+    int lock_pulse = -1;
+    double output_sum = 0;
+    double output_squares = 0;
+    double input_sum = 0;
+    double input_squares = 0;
+    int inputs = 0;
+    int predictions = 0;
+    for (int pulse = 0; pulse < STREAM_BEATS * MIDI_CLOCK_PPQN; pulse++)
+    {
+        double ideal = start + pulse * period;
+        double jitter = pulse_jitter(stream, ideal);
+        midi_pll_input(&pll, (uint64_t)(ideal + jitter));
+        lock_pulse = (pll.locked && lock_pulse < 0) ? pulse : lock_pulse;
+        if (pulse <= SETTLE_BEATS * MIDI_CLOCK_PPQN)
+        {
+            continue;
+        }
+        input_sum += jitter;
+        input_squares += jitter * jitter;
+        inputs++;
+
+        // The beat is predicted on the last pulse before it. A constant delay of the stream is not jitter.
+        if (pulse % MIDI_CLOCK_PPQN == MIDI_CLOCK_PPQN - 1)
+        {
+            double error = midi_pll_next_beat_time(&pll) - (ideal + period);
+            output_sum += error;
+            output_squares += error * error;
+            predictions++;
+        }
+    }
+    double output_mean = output_sum / predictions;
+    double output_rms = sqrt(output_squares / predictions - output_mean * output_mean);
+    double input_mean = input_sum / inputs;
+    double input_rms = sqrt(input_squares / inputs - input_mean * input_mean);
+    printf("%3.0f bpm %s jitter %4.0f us: lock after %d pulses, beat jitter rms %.1f us, pulse jitter rms %.1f us\n",
+           stream->bpm, (stream->jitter == JITTER_USB) ? "usb" : "gaussian", stream->jitter_us, lock_pulse, output_rms,
+           input_rms);
+
+    uint64_t period_num;
+    uint32_t period_den;
+    midi_pll_beat_period(&pll, &period_num, &period_den);
+    double bpm = 60e6 * period_den / period_num;
+    CHECK(lock_pulse >= 0 && lock_pulse <= 2 * MIDI_CLOCK_PPQN, "%.0f bpm locked after %d pulses", stream->bpm, lock_pulse);
+    CHECK(output_rms < input_rms / 2, "%.0f bpm beat jitter %.1f us from input jitter %.1f us", stream->bpm, output_rms, input_rms);
+    CHECK(fabs(bpm - stream->bpm) < stream->bpm / 1000, "%.0f bpm followed as %.2f bpm", stream->bpm, bpm);
+}
+
+/**
+ * A tempo jump loses the lock and the new tempo is acquired again
+ *
+ * @return void.
+ */
+static void test_tempo_jump(void)
+{
+    midi_pll_t pll;
+    midi_pll_init(&pll);
+    midi_pll_start(&pll);
+    double time = 1e6;
+    for (int pulse = 0; pulse < 20 * MIDI_CLOCK_PPQN; pulse++)
+    {
+        midi_pll_input(&pll, (uint64_t)time);
+        time += 60e6 / 120 / MIDI_CLOCK_PPQN;
+    }
+    CHECK(pll.locked, "not locked at 120 bpm");
+    int relock_pulse = -1;
+    bool lost = false;
+    for (int pulse = 0; pulse < 20 * MIDI_CLOCK_PPQN; pulse++)
+    {
+        midi_pll_input(&pll, (uint64_t)time);
+        time += 60e6 / 90 / MIDI_CLOCK_PPQN;
+        lost = lost || !pll.locked;
+        relock_pulse = (lost && pll.locked && relock_pulse < 0) ? pulse : relock_pulse;
+    }
+    uint64_t period_num;
+    uint32_t period_den;
+    midi_pll_beat_period(&pll, &period_num, &period_den);
+    CHECK(relock_pulse >= 0 && relock_pulse < 8 * MIDI_CLOCK_PPQN, "locked to the new tempo after %d pulses", relock_pulse);
+    CHECK(fabs(60e6 * period_den / period_num - 90) < 0.1, "followed as %.2f bpm", 60e6 * period_den / period_num);
+}
+
+int main(void)
+{
+    srand(2);
+    for (int i = 0; i < sizeof(streams) / sizeof(streams[0]); i++)
+    {
+        replay(&streams[i]);
+    }
+    test_tempo_jump();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+// The static edge stamping and byte handling of the MIDI input are reached by including the module
+#include "midi_sync.c"
+#include "sim_idf.h"
+#include "test_check.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define BIT_US (1000000 / MIDI_BAUD_RATE) // Length of one bit on the line
+#define STREAM_BEATS 64                   // beats of the followed clock stream
+#define SETTLE_BEATS 16                   // beats before the clicks are compared with the clock
+#define USB_FRAME_US 1000                 // the replayed clock arrives on 1 ms USB frames
+#define MAX_CLICKS 256                    // click edges recorded
+
+static midi_pll_t pll;
+static uint32_t sync_pulses[STREAM_BEATS];
+static uint32_t sync_count = 0;
+static uint64_t clicks[MAX_CLICKS];
+static uint32_t click_count = 0;
+static double stream_first = 0;
+
+esp_err_t __real_output_handler_sync(uint64_t beat_time, uint64_t period_num, uint32_t period_den);
+
+// Count the syncs of the timeline and pass them on, the sync of a Start is not one of them
+esp_err_t __wrap_output_handler_sync(uint64_t beat_time, uint64_t period_num, uint32_t period_den)
+{
+    if (pll.pulse == UINT32_MAX)
+    {
+        return __real_output_handler_sync(beat_time, period_num, period_den);
+    }
+    if (sync_count < STREAM_BEATS)
+    {
+        sync_pulses[sync_count] = pll.pulse;
+    }
+    sync_count++;
+    return __real_output_handler_sync(beat_time, period_num, period_den);
+}
+
+static void gpio_hook(gpio_num_t pin, uint32_t level)
+{
+    if (pin == OUTPUT_PIN && level && click_count < MAX_CLICKS)
+    {
+        clicks[click_count++] = sim_time();
+    }
+}
+
+/**
+ * Play a byte on the RX line and call the edge ISR on its falling edges: the start bit and every data bit
+ * that is a zero after a one
+ *
+ * @param uint8_t byte Byte to play.
+ * @param uint64_t start Time of the start bit.
+ * @return void.
+ */
+static void line_byte(uint8_t byte, uint64_t start)
+{
+    sim_run_until(start);
+    rx_edge_isr_handler(NULL);
+    for (int bit = 1; bit < 8; bit++)
+    {
+        if ((byte >> (bit - 1) & 1) && !(byte >> bit & 1))
+        {
+            sim_run_until(start + (uint64_t)(bit + 1) * BIT_US);
+            rx_edge_isr_handler(NULL);
+        }
+    }
+}
+
+/**
+ * Return the stamps waiting in the edge ring
+ *
+ * @return uint32_t waiting stamps.
+ */
+static uint32_t waiting_edges(void)
+{
+    return atomic_load(&edge_ring_head) - atomic_load(&edge_ring_tail);
+}
+
+/**
+ * A burst of back to back bytes read at once gets the start bit time of every byte, a glitch is dropped
+ * once the bytes are read and lost stamps fall back to the read time
+ *
+ * @return void.
+ */
+static void test_byte_times(void)
+{
+    static const uint8_t burst[] = {MIDI_SONG_POSITION, 0x55, 0x2A, MIDI_TIMING_CLOCK, 0x90, 0x3C, 0x64, MIDI_START, 0xFF, 0x00};
+    uint64_t start = sim_time() + 1000;
+    for (int i = 0; i < sizeof(burst); i++)
+    {
+        line_byte(burst[i], start + i * FRAME_US);
+    }
+    sim_run_until(start + sizeof(burst) * FRAME_US + 800);
+    uint32_t wrong_times = 0;
+    for (int i = 0; i < sizeof(burst); i++)
+    {
+        wrong_times += take_byte_time(burst[i], sim_time()) != start + i * FRAME_US;
+    }
+    CHECK(wrong_times == 0, "%u of %u bytes with a wrong time", wrong_times, (uint32_t)sizeof(burst));
+    CHECK(waiting_edges() == 0, "%u stamps left after the burst", waiting_edges());
+
+    // A glitch without a byte is dropped once it is older than two frames
+    uint64_t glitch = sim_time() + 500;
+    sim_run_until(glitch);
+    rx_edge_isr_handler(NULL);
+    drop_stale_edges(glitch + FRAME_US);
+    CHECK(waiting_edges() == 1, "stamp of a byte still arriving dropped");
+    sim_run_until(glitch + 2 * FRAME_US + 1);
+    drop_stale_edges(sim_time());
+    line_byte(MIDI_TIMING_CLOCK, sim_time() + 100);
+    uint64_t clock_time = sim_time();
+    sim_run_until(clock_time + 500);
+    CHECK(take_byte_time(MIDI_TIMING_CLOCK, sim_time()) == clock_time, "clock after the glitch misplaced");
+
+    // A task too far behind loses the stamps of the last bytes, they get the read time and the ring lines up again
+    start = sim_time() + 1000;
+    for (int i = 0; i < MIDI_SYNC_EDGE_RING_SIZE + 6; i++)
+    {
+        line_byte(MIDI_TIMING_CLOCK, start + i * FRAME_US);
+    }
+    uint64_t read_time = start + (MIDI_SYNC_EDGE_RING_SIZE + 6) * FRAME_US;
+    sim_run_until(read_time);
+    uint32_t stamped = 0;
+    uint32_t fallbacks = 0;
+    for (int i = 0; i < MIDI_SYNC_EDGE_RING_SIZE + 6; i++)
+    {
+        uint64_t time = take_byte_time(MIDI_TIMING_CLOCK, read_time);
+        stamped += time == start + i * FRAME_US;
+        fallbacks += time == read_time;
+    }
+    CHECK(stamped == MIDI_SYNC_EDGE_RING_SIZE && fallbacks == 6, "%u stamped and %u read times after the overflow",
+          stamped, fallbacks);
+    line_byte(MIDI_TIMING_CLOCK, sim_time() + 100);
+    clock_time = sim_time();
+    sim_run_until(clock_time + 500);
+    CHECK(take_byte_time(MIDI_TIMING_CLOCK, sim_time()) == clock_time, "clock after the overflow misplaced");
+}
+
+/**
+ * Follow a USB jittered clock: the timeline is synced once a beat, the followed tempo is shown without losing
+ * a candidate the user is changing, and the clicks land on the clock beats
+ *
+ * @return void.
+ */
+static void test_follow(void)
+{
+    sim_set_gpio_hook(gpio_hook);
+    CHECK(start_output_handler() == ESP_OK, "output handler start failed");
+    change_bpm(5);
+    midi_pll_init(&pll);
+
+    double period = 60e6 / 126 / MIDI_CLOCK_PPQN;
+    double first = sim_time() + 100000;
+    stream_first = first;
+    srand(3);
+    uint64_t read_time = 0;
+    uint32_t lock_beat = STREAM_BEATS;
+    for (int pulse = -1; pulse < STREAM_BEATS * MIDI_CLOCK_PPQN; pulse++)
+    {
+        // Start one frame before the first clock, then the clocks delayed to the next USB frame
+        double ideal = first + pulse * period;
+        uint8_t byte = (pulse < 0) ? MIDI_START : MIDI_TIMING_CLOCK;
+        uint64_t start = (uint64_t)(ceil(ideal / USB_FRAME_US) * USB_FRAME_US) + rand() % 300;
+        line_byte(byte, start);
+        read_time = start + FRAME_US + rand() % 500;
+        sim_run_until(read_time);
+        handle_byte(&pll, byte, take_byte_time(byte, read_time));
+        drop_stale_edges(read_time);
+        lock_beat = (pll.locked && lock_beat == STREAM_BEATS) ? pulse / MIDI_CLOCK_PPQN : lock_beat;
+        if (pulse == SETTLE_BEATS * MIDI_CLOCK_PPQN + MIDI_SYNC_PULSE)
+        {
+            click_count = 0;
+        }
+    }
+    CHECK(lock_beat <= 2, "locked on beat %u", lock_beat);
+
+    // One sync a beat on the sync pulse
+    uint32_t wrong_syncs = 0;
+    for (uint32_t i = 0; i < sync_count && i < STREAM_BEATS; i++)
+    {
+        wrong_syncs += sync_pulses[i] % MIDI_CLOCK_PPQN != MIDI_SYNC_PULSE;
+        wrong_syncs += i > 0 && sync_pulses[i] != sync_pulses[i - 1] + MIDI_CLOCK_PPQN;
+    }
+    CHECK(sync_count + lock_beat + 1 >= STREAM_BEATS && sync_count <= STREAM_BEATS && wrong_syncs == 0,
+          "%u syncs over %u beats, %u off the sync pulse", sync_count, STREAM_BEATS - lock_beat, wrong_syncs);
+    CHECK(get_selected_bpm() == 126, "followed as %u bpm", get_selected_bpm());
+    CHECK(get_candidate_bpm() == BPM_START + 5, "candidate %u bpm lost", get_candidate_bpm());
+
+    // The clicks after settling keep a constant delay from the clock beats
+    uint32_t beats = STREAM_BEATS - SETTLE_BEATS - 1;
+    CHECK(click_count == beats, "%u clicks over %u beats", click_count, beats);
+    double delays[MAX_CLICKS];
+    double delay_sum = 0;
+    for (uint32_t i = 0; i < click_count && i < beats; i++)
+    {
+        delays[i] = clicks[i] - (first + (SETTLE_BEATS + 1 + i) * MIDI_CLOCK_PPQN * period);
+        delay_sum += delays[i];
+    }
+    double mean = delay_sum / beats;
+    double worst = 0;
+    for (uint32_t i = 0; i < click_count && i < beats; i++)
+    {
+        worst = (fabs(delays[i] - mean) > worst) ? fabs(delays[i] - mean) : worst;
+    }
+    printf("locked on beat %u, clicks %.0f us after the clock beats, spread %.0f us\n", lock_beat, mean, worst);
+    CHECK(mean > 0 && mean < USB_FRAME_US, "clicks %.0f us from the clock beats", mean);
+    CHECK(worst < 500, "click spread %.0f us", worst);
+}
+
+/**
+ * Play one byte of the followed stream, delayed to the next USB frame and read back by the task
+ *
+ * @param uint8_t byte Byte to play.
+ * @param double time Ideal time of the byte.
+ * @return void.
+ */
+static void stream_byte(uint8_t byte, double time)
+{
+    uint64_t start = (uint64_t)(ceil(time / USB_FRAME_US) * USB_FRAME_US) + rand() % 300;
+    line_byte(byte, start);
+    uint64_t read_time = start + FRAME_US + rand() % 500;
+    sim_run_until(read_time);
+    handle_byte(&pll, byte, take_byte_time(byte, read_time));
+    drop_stale_edges(read_time);
+}
+
+/**
+ * A Start in the middle of a beat moves the next click onto the first clock after it, not onto the beat the
+ * clicks were following before
+ *
+ * @return void.
+ */
+static void test_start(void)
+{
+    double period = 60e6 / 126 / MIDI_CLOCK_PPQN;
+    uint32_t pulse = STREAM_BEATS * MIDI_CLOCK_PPQN;
+    for (; pulse < (STREAM_BEATS + 1) * MIDI_CLOCK_PPQN + 5; pulse++)
+    {
+        stream_byte(MIDI_TIMING_CLOCK, stream_first + pulse * period);
+    }
+    stream_byte(MIDI_START, stream_first + (pulse - 0.5) * period);
+    CHECK(get_beat() == 1, "Start left the bar on beat %u", get_beat());
+    click_count = 0;
+    uint32_t downbeat = pulse;
+    for (; pulse < downbeat + 2 * MIDI_CLOCK_PPQN + 1; pulse++)
+    {
+        stream_byte(MIDI_TIMING_CLOCK, stream_first + pulse * period);
+    }
+    uint32_t late_clicks = 0;
+    for (uint32_t i = 0; i < click_count; i++)
+    {
+        double delay = clicks[i] - (stream_first + (downbeat + i * MIDI_CLOCK_PPQN) * period);
+        late_clicks += delay < 0 || delay > 2 * USB_FRAME_US;
+    }
+    CHECK(click_count == 3 && late_clicks == 0, "%u of %u clicks off the clock beats after Start", late_clicks,
+          click_count);
+}
+
+int main(void)
+{
+    test_byte_times();
+    test_follow();
+    test_start();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
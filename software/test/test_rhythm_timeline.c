@@ -0,0 +1,127 @@
+#include "rhythm_timeline.h"
+#include "test_check.h"
+
+#define MAX_PULSES 8 // voices of up to this many pulses are checked against the reference
+#define MAX_BEATS 4  // over up to this many beats
+
+/**
+ * Check a timeline against every pulse of every voice placed on the grid one position at a time
+ *
+ * @param const rhythm_timeline_t* timeline Built timeline.
+ * @param const rhythm_voice_t* voices Voices on top of the main beat.
+ * @param uint8_t voice_count Number of voices.
+ * @return int number of wrong or missing events.
+ */
+static int check_timeline(const rhythm_timeline_t *timeline, const rhythm_voice_t *voices, uint8_t voice_count)
+{
+    int wrong_events = 0;
+    uint32_t ticks = timeline->ticks_per_beat;
+    uint16_t event = 0;
+    for (uint32_t position = 0; position < timeline->cycle_beats * ticks; position++)
+    {
+        // Pulse k of a voice lies at k * beats / pulses beats
+        uint8_t expected = (position % ticks == 0) ? RHYTHM_MAIN_VOICE : 0;
+        for (int i = 0; i < voice_count; i++)
+        {
+            expected |= (position * voices[i].pulses % (voices[i].beats * ticks) == 0) ? 1 << (i + 1) : 0;
+        }
+        if (expected == 0)
+        {
+            continue;
+        }
+        if (event >= timeline->event_count)
+        {
+            wrong_events++;
+            continue;
+        }
+        const rhythm_event_t *found = &timeline->events[event++];
+        wrong_events += found->beat != position / ticks || found->tick != position % ticks || found->voices != expected;
+    }
+    return wrong_events + timeline->event_count - event;
+}
+
+/**
+ * Merge a subdivision with a polyrhythm on the smallest grid that holds both
+ *
+ * @return void.
+ */
+static void test_merge(void)
+{
+    rhythm_timeline_t timeline;
+    const rhythm_voice_t voices[] = {{2, 1}, {3, 2}, {5, 4}};
+    CHECK(rhythm_timeline_build(&timeline, voices, 3) == ESP_OK, "build failed");
+    CHECK(timeline.ticks_per_beat == 30 && timeline.cycle_beats == 4, "grid of %u ticks over %u beats",
+          timeline.ticks_per_beat, timeline.cycle_beats);
+    CHECK(timeline.events[0].beat == 0 && timeline.events[0].tick == 0 && timeline.events[0].voices == 0x0F,
+          "first event sounds voices %02x", timeline.events[0].voices);
+    CHECK(check_timeline(&timeline, voices, 3) == 0, "%d wrong events", check_timeline(&timeline, voices, 3));
+
+    // The main beat alone is one event per beat
+    CHECK(rhythm_timeline_build(&timeline, NULL, 0) == ESP_OK && timeline.event_count == 1 &&
+              timeline.ticks_per_beat == 1 && timeline.events[0].voices == RHYTHM_MAIN_VOICE,
+          "main beat timeline of %u events", timeline.event_count);
+}
+
+/**
+ * Every pair of small voices matches the reference and starts each beat with the main voice
+ *
+ * @return void.
+ */
+static void test_pairs(void)
+{
+    int wrong_timelines = 0;
+    int checked = 0;
+    rhythm_timeline_t timeline;
+    for (int first = 0; first < MAX_PULSES * MAX_BEATS; first++)
+    {
+        for (int second = first; second < MAX_PULSES * MAX_BEATS; second++)
+        {
+            rhythm_voice_t voices[] = {{first % MAX_PULSES + 1, first / MAX_PULSES + 1},
+                                       {second % MAX_PULSES + 1, second / MAX_PULSES + 1}};
+            if (rhythm_timeline_build(&timeline, voices, 2) != ESP_OK)
+            {
+                continue;
+            }
+            checked++;
+            int wrong_events = check_timeline(&timeline, voices, 2);
+            for (int i = 0; i < timeline.event_count; i++)
+            {
+                wrong_events += timeline.events[i].tick == 0 && !(timeline.events[i].voices & RHYTHM_MAIN_VOICE);
+            }
+            wrong_timelines += wrong_events != 0;
+        }
+    }
+    printf("%d voice pairs merged\n", checked);
+    CHECK(wrong_timelines == 0, "%d of %d timelines differ from the reference", wrong_timelines, checked);
+}
+
+/**
+ * Invalid voices and timelines that do not fit are refused
+ *
+ * @return void.
+ */
+static void test_limits(void)
+{
+    rhythm_timeline_t timeline;
+    const rhythm_voice_t voices[RHYTHM_MAX_VOICES + 1] = {{2, 1}, {3, 1}, {4, 1}, {5, 1}, {6, 1}};
+    const rhythm_voice_t no_pulses = {0, 1};
+    const rhythm_voice_t no_beats = {3, 0};
+    const rhythm_voice_t long_cycle = {1, RHYTHM_MAX_CYCLE_BEATS + 1};
+    const rhythm_voice_t many_events[] = {{1, RHYTHM_MAX_CYCLE_BEATS}, {8, 1}};
+    CHECK(rhythm_timeline_build(&timeline, voices, RHYTHM_MAX_VOICES + 1) == ESP_ERR_INVALID_ARG, "too many voices built");
+    CHECK(rhythm_timeline_build(&timeline, voices, RHYTHM_MAX_VOICES) == ESP_OK, "all voices refused");
+    CHECK(rhythm_timeline_build(&timeline, NULL, 1) == ESP_ERR_INVALID_ARG, "missing voices built");
+    CHECK(rhythm_timeline_build(&timeline, &no_pulses, 1) == ESP_ERR_INVALID_ARG, "voice without pulses built");
+    CHECK(rhythm_timeline_build(&timeline, &no_beats, 1) == ESP_ERR_INVALID_ARG, "voice without beats built");
+    CHECK(rhythm_timeline_build(&timeline, &long_cycle, 1) == ESP_ERR_NO_MEM, "cycle too long built");
+    CHECK(rhythm_timeline_build(&timeline, many_events, 2) == ESP_ERR_NO_MEM, "too many events built");
+}
+
+int main(void)
+{
+    test_merge();
+    test_pairs();
+    test_limits();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,326 @@
+// The static frame composition and flushing of the screen handler are reached by including the module
+#include "screen_handler.c"
+#include "driver/i2c.h"
+#include "test_check.h"
+#include <stdlib.h>
+
+#define MAX_TRANSACTION 1024 // bytes queued in one I2C transaction
+#define I2C_BIT_US 2.5       // 400 kHz bus
+
+// I2C transaction queued by the panel driver
+struct i2c_cmd_link
+{
+    uint8_t bytes[MAX_TRANSACTION];
+    size_t length;
+};
+
+// Stand-in of the SSD1306 on the bus, decoding the command and data streams into its display RAM
+static uint8_t panel_ram[SCREEN_PAGES][SCREEN_COLUMNS];
+static uint8_t column_start, column_end, page_start, page_end;
+static uint8_t column_pointer, page_pointer;
+static bool horizontal = false;
+static bool remapped = true;
+static uint32_t transactions = 0;
+static double bus_us = 0;
+static int fail_transaction = -1; // Transaction left unacknowledged, counted from the next one
+
+i2c_cmd_handle_t i2c_cmd_link_create(void)
+{
+    return calloc(1, sizeof(struct i2c_cmd_link));
+}
+
+void i2c_cmd_link_delete(i2c_cmd_handle_t cmd)
+{
+    free(cmd);
+}
+
+esp_err_t i2c_master_start(i2c_cmd_handle_t cmd)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_stop(i2c_cmd_handle_t cmd)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_write(i2c_cmd_handle_t cmd, const uint8_t *data, size_t data_len, bool ack_en)
+{
+    CHECK(cmd->length + data_len <= MAX_TRANSACTION, "transaction of %zu bytes", cmd->length + data_len);
+    memcpy(&cmd->bytes[cmd->length], data, data_len);
+    cmd->length += data_len;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t cmd, uint8_t data, bool ack_en)
+{
+    return i2c_master_write(cmd, &data, 1, ack_en);
+}
+
+/**
+ * Run the commands of a command stream
+ *
+ * @param const uint8_t* commands Command bytes.
+ * @param size_t length Number of bytes.
+ * @return void.
+ */
+static void run_commands(const uint8_t *commands, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        switch (commands[i])
+        {
+        case SSD1306_SET_MEMORY_ADDRESSING_MODE:
+            horizontal = commands[++i] == SSD1306_HORIZONTAL_ADDRESSING;
+            break;
+        case SSD1306_SET_COLUMN_ADDRESS:
+            column_start = column_pointer = commands[++i];
+            column_end = commands[++i];
+            break;
+        case SSD1306_SET_PAGE_ADDRESS:
+            page_start = page_pointer = commands[++i];
+            page_end = commands[++i];
+            break;
+        case SSD1306_SEGMENT_REMAP_NORMAL:
+        case SSD1306_SEGMENT_REMAP_REVERSE:
+            remapped = commands[i] == SSD1306_SEGMENT_REMAP_REVERSE;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+esp_err_t i2c_master_cmd_begin(int i2c_num, i2c_cmd_handle_t cmd, TickType_t ticks_to_wait)
+{
+    // Address and control byte, then the stream. Every byte takes 9 bits, start and stop one bit each.
+    transactions++;
+    bus_us += (cmd->length * 9 + 2) * I2C_BIT_US;
+    if (fail_transaction >= 0 && fail_transaction-- == 0)
+    {
+        return ESP_FAIL;
+    }
+    CHECK(cmd->length >= 2 && cmd->bytes[0] == (dev._address << 1), "transaction not addressed to the panel");
+    if (cmd->bytes[1] == SSD1306_CONTROL_COMMAND_STREAM)
+    {
+        run_commands(&cmd->bytes[2], cmd->length - 2);
+        return ESP_OK;
+    }
+
+    // Horizontal addressing wraps to the next page at the end column and back to the first page at the end
+    CHECK(horizontal, "data sent in page addressing");
+    for (size_t i = 2; i < cmd->length; i++)
+    {
+        panel_ram[page_pointer][column_pointer] = cmd->bytes[i];
+        if (column_pointer++ == column_end)
+        {
+            column_pointer = column_start;
+            page_pointer = (page_pointer == page_end) ? page_start : page_pointer + 1;
+        }
+    }
+    return ESP_OK;
+}
+
+void i2c_master_init(SSD1306_t *dev, int16_t sda, int16_t scl, int16_t reset)
+{
+    dev->_address = 0x3C;
+}
+
+void ssd1306_init(SSD1306_t *dev, int width, int height)
+{
+}
+
+void ssd1306_contrast(SSD1306_t *dev, int contrast)
+{
+}
+
+void ssd1306_clear_screen(SSD1306_t *dev, bool invert)
+{
+    memset(panel_ram, invert ? 0xFF : 0x00, sizeof(panel_ram));
+}
+
+// Glyphs with a pattern of their own instead of the decoded bitmaps
+const uint8_t *glyph_store_get(uint8_t glyph)
+{
+    static uint8_t image[GLYPH_IMAGE_SIZE];
+    for (int i = 0; i < GLYPH_IMAGE_SIZE; i++)
+    {
+        image[i] = (uint8_t)(glyph * 37 + i * (glyph + 1));
+    }
+    return image;
+}
+
+// The screen task is not run
+TickType_t xTaskGetTickCount(void)
+{
+    return 0;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks)
+{
+    return pdFALSE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return NULL;
+}
+
+/**
+ * Flush the frame and report what it cost on the bus
+ *
+ * @param const char* name Name of the change.
+ * @return void.
+ */
+static void flush(const char *name)
+{
+    transactions = 0;
+    bus_us = 0;
+    flush_frame();
+    printf("%-24s %3u bytes in %2u transactions, %6.0f us bus time\n", name, transactions ? screen_stats.last_frame_bytes : 0,
+           transactions, bus_us);
+}
+
+/**
+ * Check that the panel shows the frame and the shadow matches it
+ *
+ * @param const char* name Name of the change.
+ * @return void.
+ */
+static void check_panel(const char *name)
+{
+    CHECK(memcmp(panel_ram, frame, sizeof(frame)) == 0, "panel differs from the frame after %s", name);
+    CHECK(memcmp(shadow, frame, sizeof(frame)) == 0, "shadow differs from the frame after %s", name);
+}
+
+/**
+ * Send changes of different shapes and check the windows they take
+ *
+ * @return void.
+ */
+static void test_spans(void)
+{
+    // Unknown panel content sends the whole frame as one window
+    srand(4);
+    for (int page = 0; page < SCREEN_PAGES; page++)
+    {
+        for (int column = 0; column < SCREEN_COLUMNS; column++)
+        {
+            frame[page][column] = rand();
+        }
+    }
+    shadow_valid = false;
+    flush("full frame");
+    CHECK(transactions == 2 && screen_stats.last_frame_bytes == SCREEN_PAGES * SCREEN_COLUMNS, "full frame took %u transactions", transactions);
+    check_panel("the full frame");
+
+    // Two changed digits send their spans instead of everything between them
+    for (int page = 0; page < SCREEN_PAGES; page++)
+    {
+        for (int column = 30; column < 50; column += 2)
+        {
+            frame[page][column] ^= 1;
+            frame[page][column + 70] ^= 1;
+        }
+    }
+    flush("two digits");
+    CHECK(transactions == 2 * 2 * SCREEN_PAGES && screen_stats.last_frame_bytes == 2 * SCREEN_PAGES * 19,
+          "two digits sent %u bytes in %u transactions", screen_stats.last_frame_bytes, transactions);
+    check_panel("two digits");
+
+    // A small change in one page sends its span only
+    frame[2][64] ^= 0x80;
+    frame[2][66] ^= 0x80;
+    flush("small change");
+    CHECK(transactions == 2 && screen_stats.last_frame_bytes == 3, "small change sent %u bytes in %u transactions",
+          screen_stats.last_frame_bytes, transactions);
+    check_panel("the small change");
+
+    // An unchanged frame sends nothing and is not counted
+    uint32_t frames = screen_stats.frames;
+    flush("unchanged frame");
+    CHECK(transactions == 0 && screen_stats.frames == frames, "unchanged frame sent");
+
+    // Scattered changes cost less as one window than as many spans
+    for (int page = 0; page < SCREEN_PAGES; page++)
+    {
+        for (int column = 0; column < SCREEN_COLUMNS; column += 7)
+        {
+            frame[page][column] ^= 0x10;
+        }
+    }
+    flush("scattered changes");
+    CHECK(transactions == 2, "scattered changes took %u transactions", transactions);
+    check_panel("the scattered changes");
+}
+
+/**
+ * Compose a tempo change, only the changed digit is sent
+ *
+ * @return void.
+ */
+static void test_compose(void)
+{
+    state_snapshot_t snapshot = {.bpm_candidate = 120, .signature_mode = 0};
+    compose_state(&snapshot);
+    flush("compose 120 bpm");
+    check_panel("composing 120 bpm");
+    snapshot.bpm_candidate = 121;
+    compose_state(&snapshot);
+    flush("compose 121 bpm");
+    CHECK(transactions <= 2 * SCREEN_PAGES, "ones digit took %u transactions", transactions);
+    CHECK(screen_stats.last_frame_bytes <= SCREEN_PAGES * GLYPH_COLUMNS, "ones digit sent %u bytes", screen_stats.last_frame_bytes);
+    check_panel("composing 121 bpm");
+}
+
+/**
+ * A frame the panel does not acknowledge is counted and sent again with the next flush
+ *
+ * @return void.
+ */
+static void test_failure(void)
+{
+    uint32_t failed = screen_stats.failed;
+    frame[0][10] ^= 0xFF;
+    frame[3][100] ^= 0xFF;
+    fail_transaction = 1; // The data of the first span
+    flush("unacknowledged frame");
+    CHECK(screen_stats.failed == failed + 1, "failure not counted");
+    CHECK(shadow[0][10] != frame[0][10], "shadow updated without the data");
+    CHECK(screen_stats.last_frame_transactions == 0 && screen_stats.last_frame_bytes == 0,
+          "failed window counted as %u bytes in %u transactions", screen_stats.last_frame_bytes,
+          screen_stats.last_frame_transactions);
+    flush("resent frame");
+    check_panel("resending");
+}
+
+/**
+ * Rotating sets the remap and scan direction, the whole picture is written again afterwards
+ *
+ * @return void.
+ */
+static void test_rotation(void)
+{
+    transactions = 0;
+    CHECK(screen_panel_set_rotation(&dev, true) == ESP_OK && !remapped && transactions == 1, "rotation not set");
+    CHECK(screen_panel_set_rotation(&dev, false) == ESP_OK && remapped, "rotation not cleared");
+}
+
+int main(void)
+{
+    // The page addressed drawing of the ssd1306 component sets the page and column and writes the rows of a glyph
+    // in a transaction each, every glyph page of every frame
+    double glyph_page_us = ((2 + 3) * 9 + 2 + (2 + GLYPH_COLUMNS) * 9 + 2) * I2C_BIT_US;
+    printf("%-24s %3u bytes in %2u transactions, %6.0f us bus time\n", "page addressed frame", 4 * GLYPH_IMAGE_SIZE,
+           4 * GLYPH_PAGES * 2, 4 * GLYPH_PAGES * glyph_page_us);
+
+    i2c_master_init(&dev, 0, 0, 0);
+    ssd1306_clear_screen(&dev, false);
+    CHECK(screen_panel_init(&dev, false) == ESP_OK && horizontal, "panel not in horizontal addressing");
+    test_spans();
+    test_compose();
+    test_failure();
+    test_rotation();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
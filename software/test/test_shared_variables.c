@@ -0,0 +1,184 @@
+#include "shared_variables.h"
+#include "meter_patterns.h"
+#include "settings.h"
+#include "test_check.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define WRITES 2000000 // modifications made by each writer
+#define WRITERS 2      // concurrent writer threads
+#define READERS 2      // concurrent reader threads
+
+// Notifications received by the stand-in subscriber
+static _Atomic uint32_t notified_changes = 0;
+static _Atomic uint32_t notifications = 0;
+static int subscriber_task;
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    atomic_fetch_or(&notified_changes, value);
+    atomic_fetch_add(&notifications, 1);
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *high_task_awoken)
+{
+    *high_task_awoken = pdTRUE;
+    return xTaskNotify(task, value, action);
+}
+
+// Set by the main thread when the writers are done
+static atomic_bool writers_done = false;
+
+// Bpm values written by the following writer, see follow_writer
+static const uint16_t followed_bpms[] = {BPM_START, 111, 888};
+
+/**
+ * Check the invariants every snapshot must keep, a torn read of a half written state breaks them
+ *
+ * @param const state_snapshot_t* snapshot Snapshot to check.
+ * @param bool followed The bpm is only changed through set_followed_bpm.
+ * @return bool true if the snapshot is consistent.
+ */
+static bool consistent(const state_snapshot_t *snapshot, bool followed)
+{
+    if (snapshot->signature_mode >= METER_PATTERN_COUNT ||
+        snapshot->current_beat < 1 || snapshot->current_beat > get_meter_pattern(snapshot->signature_mode)->length)
+    {
+        return false;
+    }
+    if (followed)
+    {
+        // The candidate follows the selected bpm, both always have one of the written values
+        bool known = false;
+        for (int i = 0; i < sizeof(followed_bpms) / sizeof(followed_bpms[0]); i++)
+        {
+            known = known || snapshot->bpm_selected == followed_bpms[i];
+        }
+        return known && snapshot->bpm_candidate == snapshot->bpm_selected;
+    }
+
+    // Every writer changes the candidate by +5 and -5 in turns
+    return snapshot->bpm_candidate % 5 == 0 && snapshot->bpm_candidate >= BPM_START - 5 * WRITERS &&
+           snapshot->bpm_candidate <= BPM_START + 5 * WRITERS;
+}
+
+static void *follow_writer(void *arg)
+{
+    for (int i = 0; i < WRITES; i++)
+    {
+        set_followed_bpm(followed_bpms[1 + (i & 1)]);
+        increment_beat();
+        if (i % 1000 == 0)
+        {
+            change_signature_mode();
+        }
+    }
+    return NULL;
+}
+
+static void *change_writer(void *arg)
+{
+    for (int i = 0; i < WRITES; i++)
+    {
+        change_bpm((i & 1) ? -5 : 5);
+        increment_beat();
+        if (i % 1000 == 0)
+        {
+            set_signature_mode(i / 1000);
+        }
+    }
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    bool followed = *(bool *)arg;
+    uintptr_t torn = 0;
+    while (!atomic_load(&writers_done))
+    {
+        state_snapshot_t snapshot;
+        get_state_snapshot(&snapshot);
+        torn += !consistent(&snapshot, followed);
+    }
+    return (void *)torn;
+}
+
+/**
+ * Run concurrent readers against concurrent writers and count the inconsistent snapshots
+ *
+ * @param writer Writer thread function.
+ * @param bool followed The writer changes the bpm through set_followed_bpm.
+ * @return void.
+ */
+static void stress(void *(*writer)(void *), bool followed)
+{
+    pthread_t writers[WRITERS];
+    pthread_t readers[READERS];
+    atomic_store(&writers_done, false);
+    for (int i = 0; i < READERS; i++)
+    {
+        pthread_create(&readers[i], NULL, reader, &followed);
+    }
+    for (int i = 0; i < WRITERS; i++)
+    {
+        pthread_create(&writers[i], NULL, writer, NULL);
+    }
+    for (int i = 0; i < WRITERS; i++)
+    {
+        pthread_join(writers[i], NULL);
+    }
+    atomic_store(&writers_done, true);
+    uintptr_t torn = 0;
+    for (int i = 0; i < READERS; i++)
+    {
+        void *result;
+        pthread_join(readers[i], &result);
+        torn += (uintptr_t)result;
+    }
+    CHECK(torn == 0, "%lu inconsistent snapshots", (unsigned long)torn);
+}
+
+/**
+ * Check that the subscriber is notified about the changes in its mask only
+ *
+ * @return void.
+ */
+static void test_notifications(void)
+{
+    subscribe_state_changes(&subscriber_task, STATE_CHANGE_BPM_CANDIDATE | STATE_CHANGE_CURRENT_BEAT);
+    atomic_store(&notified_changes, 0);
+    atomic_store(&notifications, 0);
+
+    switch_system_off();
+    CHECK(atomic_load(&notifications) == 0, "notified about a change outside the mask");
+    change_bpm(1);
+    CHECK(atomic_load(&notified_changes) == STATE_CHANGE_BPM_CANDIDATE, "changes 0x%x", (unsigned)atomic_load(&notified_changes));
+    change_bpm(0);
+    CHECK(atomic_load(&notifications) == 1, "notified about an unchanged write");
+
+    BaseType_t high_task_awoken = pdFALSE;
+    increment_beat_from_isr(&high_task_awoken);
+    CHECK(high_task_awoken == pdTRUE, "the ISR was not told to yield");
+    CHECK(atomic_load(&notified_changes) & STATE_CHANGE_CURRENT_BEAT, "beat change not notified");
+
+    subscribe_state_changes(NULL, 0);
+    change_bpm(1);
+    CHECK(atomic_load(&notifications) == 2, "notified after unsubscribing");
+    switch_system_on();
+}
+
+int main(void)
+{
+    CHECK(init_shared_variables() == ESP_OK, "the state word is not lock free");
+    test_notifications();
+
+    reset_candidate_bpm();
+    set_followed_bpm(BPM_START);
+    stress(follow_writer, true);
+    set_followed_bpm(BPM_START);
+    stress(change_writer, false);
+    CHECK(get_candidate_bpm() == BPM_START, "candidate %u after balanced changes", get_candidate_bpm());
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
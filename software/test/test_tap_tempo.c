@@ -0,0 +1,136 @@
+#include "tap_tempo.h"
+#include "test_check.h"
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof(array[0]))
+
+// Intervals between the switch press edges of taps recorded along a 120 bpm click, in microseconds. Tap 8 was
+// missed and tap 11 bounced 28 ms after the press.
+static const uint32_t taps_120[] = {
+    512000, 488000, 503000, 521000, 470000, 496000, 509000, 1004000, 493000, 507000, 28000, 450000, 515000, 490000,
+    478000, 526000, 501000};
+
+// Taps recorded while the click changed from 120 to 90 bpm
+static const uint32_t taps_120_to_90[] = {
+    497000, 510000, 488000, 503000, 681000, 652000, 671000, 660000, 689000, 648000, 667000, 672000, 659000};
+
+/**
+ * Feed the taps of a recording to the estimator
+ *
+ * @param tap_tempo_t* tap_tempo Estimator to feed.
+ * @param uint64_t* time Time of the previous tap, moved to the last tap.
+ * @param const uint32_t* intervals Intervals of the recording.
+ * @param int count Intervals in the recording.
+ * @param uint16_t* estimates Tempo estimated after each tap, 0 while there is none.
+ * @return void.
+ */
+static void play(tap_tempo_t *tap_tempo, uint64_t *time, const uint32_t *intervals, int count, uint16_t *estimates)
+{
+    for (int i = 0; i < count; i++)
+    {
+        *time += intervals[i];
+        tap_tempo_tap(tap_tempo, *time);
+        if (tap_tempo_get_bpm(tap_tempo, &estimates[i]) != ESP_OK)
+        {
+            estimates[i] = 0;
+        }
+    }
+}
+
+/**
+ * A jittery recording with a missed tap and a bounce must stay on its tempo
+ *
+ * @return void.
+ */
+static void test_jitter(void)
+{
+    tap_tempo_t tap_tempo;
+    tap_tempo_init(&tap_tempo);
+    uint64_t time = 1000000;
+    tap_tempo_tap(&tap_tempo, time);
+
+    uint16_t estimates[ARRAY_LENGTH(taps_120)];
+    play(&tap_tempo, &time, taps_120, ARRAY_LENGTH(taps_120), estimates);
+    CHECK(estimates[TAP_TEMPO_MIN_INTERVALS - 2] == 0, "tempo after one interval");
+    for (int i = TAP_TEMPO_MIN_INTERVALS - 1; i < ARRAY_LENGTH(taps_120); i++)
+    {
+        CHECK(estimates[i] >= 115 && estimates[i] <= 125, "tap %d estimated %u bpm", i + 1, estimates[i]);
+    }
+    CHECK(estimates[ARRAY_LENGTH(taps_120) - 1] >= 119 && estimates[ARRAY_LENGTH(taps_120) - 1] <= 121,
+          "settled at %u bpm", estimates[ARRAY_LENGTH(taps_120) - 1]);
+}
+
+/**
+ * A lasting tempo change is followed after the outliers accepted as the new tempo
+ *
+ * @return void.
+ */
+static void test_tempo_change(void)
+{
+    tap_tempo_t tap_tempo;
+    tap_tempo_init(&tap_tempo);
+    uint64_t time = 1000000;
+    tap_tempo_tap(&tap_tempo, time);
+
+    uint16_t estimates[ARRAY_LENGTH(taps_120_to_90)];
+    play(&tap_tempo, &time, taps_120_to_90, ARRAY_LENGTH(taps_120_to_90), estimates);
+    CHECK(estimates[4] >= 115 && estimates[4] <= 125, "first slower tap moved the tempo to %u bpm", estimates[4]);
+
+    // The change starts at tap 5, it is followed within the outlier limit and half a window
+    int settled = 4 + TAP_TEMPO_MAX_OUTLIERS + TAP_TEMPO_WINDOW / 2;
+    for (int i = settled; i < ARRAY_LENGTH(taps_120_to_90); i++)
+    {
+        CHECK(estimates[i] >= 88 && estimates[i] <= 92, "tap %d estimated %u bpm after the change", i + 1, estimates[i]);
+    }
+}
+
+/**
+ * A pause longer than the timeout starts a new sequence
+ *
+ * @return void.
+ */
+static void test_timeout(void)
+{
+    tap_tempo_t tap_tempo;
+    tap_tempo_init(&tap_tempo);
+    uint64_t time = 1000000;
+    tap_tempo_tap(&tap_tempo, time);
+    uint16_t estimates[ARRAY_LENGTH(taps_120)];
+    play(&tap_tempo, &time, taps_120, ARRAY_LENGTH(taps_120), estimates);
+
+    CHECK(tap_tempo_active(&tap_tempo, time + TAP_TEMPO_TIMEOUT_US - 1), "inactive before the timeout");
+    CHECK(!tap_tempo_active(&tap_tempo, time + TAP_TEMPO_TIMEOUT_US + 1), "active after the timeout");
+    time += TAP_TEMPO_TIMEOUT_US + 1000000;
+    CHECK(!tap_tempo_tap(&tap_tempo, time), "interval added across the timeout");
+    uint16_t bpm;
+    CHECK(tap_tempo_get_bpm(&tap_tempo, &bpm) == ESP_ERR_NOT_FOUND, "old tempo %u bpm kept after the timeout", bpm);
+}
+
+/**
+ * Taps faster than the bounce limit are rejected and the tempo is limited to 999 bpm
+ *
+ * @return void.
+ */
+static void test_limits(void)
+{
+    tap_tempo_t tap_tempo;
+    tap_tempo_init(&tap_tempo);
+    uint64_t time = 1000000;
+    tap_tempo_tap(&tap_tempo, time);
+    CHECK(!tap_tempo_tap(&tap_tempo, time + TAP_TEMPO_MIN_INTERVAL_US - 1), "bounce accepted");
+    for (int i = 1; i <= TAP_TEMPO_WINDOW; i++)
+    {
+        tap_tempo_tap(&tap_tempo, time + (uint64_t)i * TAP_TEMPO_MIN_INTERVAL_US);
+    }
+    uint16_t bpm;
+    CHECK(tap_tempo_get_bpm(&tap_tempo, &bpm) == ESP_OK && bpm <= 999, "fastest taps gave %u bpm", bpm);
+}
+
+int main(void)
+{
+    test_jitter();
+    test_tempo_change();
+    test_timeout();
+    test_limits();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "tempo_automation.h"
+#include "beat_scheduler.h"
+#include "test_check.h"
+#include <time.h>
+
+#define HOLD_BEATS 10000000       // beats played at a constant tempo
+#define BENCHMARK_BEATS 100000000 // beats played to measure the cost per beat
+
+/**
+ * Play a constant tempo and compare every beat timestamp with floor(n * 60e6 / bpm)
+ *
+ * @return void.
+ */
+static void test_hold_exact(void)
+{
+    tempo_automation_t automation;
+    tempo_automation_init(&automation);
+    CHECK(tempo_automation_add_hold(&automation, 7, HOLD_BEATS) == ESP_OK, "hold not added");
+    uint64_t time = 0;
+    uint64_t worst = 0;
+    for (uint64_t beat = 1; beat <= HOLD_BEATS; beat++)
+    {
+        time += tempo_automation_next_interval(&automation);
+        uint64_t exact = beat * US_PER_MINUTE / 7;
+        uint64_t error = (time > exact) ? time - exact : exact - time;
+        worst = (error > worst) ? error : worst;
+    }
+    // The Q32.32 interval is rounded down, so whole beats land a microsecond early at most
+    CHECK(worst <= 1, "beat timestamps off by up to %llu us", (unsigned long long)worst);
+    CHECK(tempo_automation_done(&automation), "beats left after the hold");
+    CHECK(tempo_automation_next_interval(&automation) == 0, "interval after the end");
+}
+
+/**
+ * Play a ramp and compare its length with the integral of the segment table and of the ideal bpm ramp
+ *
+ * @return void.
+ */
+static void test_ramp_integral(void)
+{
+    tempo_automation_t automation;
+    tempo_automation_init(&automation);
+    CHECK(tempo_automation_add_ramp(&automation, 80, 120, 128) == ESP_OK, "ramp not added");
+    CHECK(automation.segment_count == TEMPO_AUTOMATION_RAMP_PIECES, "%u segments", automation.segment_count);
+
+    // Exact sum of the fixed point intervals of the table
+    unsigned __int128 reference = 0;
+    for (int i = 0; i < automation.segment_count; i++)
+    {
+        const tempo_segment_t *segment = &automation.segments[i];
+        for (uint32_t beat = 0; beat < segment->beats; beat++)
+        {
+            reference += segment->interval + (__int128)segment->interval_step * beat;
+        }
+    }
+
+    uint64_t time = 0;
+    uint32_t beats = 0;
+    uint32_t first = 0;
+    uint32_t last = 0;
+    while (!tempo_automation_done(&automation))
+    {
+        last = tempo_automation_next_interval(&automation);
+        first = (beats++ == 0) ? last : first;
+        time += last;
+    }
+    CHECK(beats == 128, "%u beats", beats);
+    CHECK(time == (uint64_t)(reference >> TEMPO_AUTOMATION_FRACTION_BITS), "played %llu us, table integral %llu us",
+          (unsigned long long)time, (unsigned long long)(reference >> TEMPO_AUTOMATION_FRACTION_BITS));
+    CHECK(first == 750000, "first interval %u us", first);
+
+    // The pieces follow the bpm ramp, beat n is played at the bpm reached after n of the 128 beats
+    double ideal = 0;
+    for (int beat = 0; beat < 128; beat++)
+    {
+        ideal += 60e6 / (80 + 40.0 * beat / 128);
+    }
+    double error = (time > ideal) ? time - ideal : ideal - time;
+    CHECK(error < ideal / 1000, "played %llu us, ideal ramp %.0f us", (unsigned long long)time, ideal);
+}
+
+/**
+ * Play a speed trainer curve, every step must hold its tempo for its beats
+ *
+ * @return void.
+ */
+static void test_steps(void)
+{
+    tempo_automation_t automation;
+    tempo_automation_init(&automation);
+    CHECK(tempo_automation_add_steps(&automation, 60, 2, 16, 120) == ESP_OK, "steps not added");
+    CHECK(automation.segment_count == 1, "%u segments for the steps", automation.segment_count);
+
+    uint32_t beats = 0;
+    uint64_t step_time = 0;
+    uint32_t wrong_steps = 0;
+    while (!tempo_automation_done(&automation))
+    {
+        step_time += tempo_automation_next_interval(&automation);
+        if (++beats % 16 == 0)
+        {
+            uint32_t bpm = 60 + 2 * (beats / 16 - 1);
+            // The fraction carried over the step boundary moves it by a microsecond at most
+            uint64_t exact = 16 * US_PER_MINUTE / bpm;
+            wrong_steps += step_time + 1 < exact || step_time > exact + 1;
+            step_time = 0;
+        }
+    }
+    CHECK(beats == 31 * 16, "%u beats", beats);
+    CHECK(wrong_steps == 0, "%u steps with a wrong length", wrong_steps);
+    CHECK(automation.last_bpm == 120, "last bpm %u", automation.last_bpm);
+
+    // The last step is clamped to the ceiling
+    tempo_automation_init(&automation);
+    tempo_automation_add_steps(&automation, 120, 7, 1, 131);
+    uint32_t intervals[3];
+    for (int i = 0; i < 3; i++)
+    {
+        intervals[i] = tempo_automation_next_interval(&automation);
+    }
+    CHECK(tempo_automation_done(&automation), "steps left after the ceiling");
+    // 60e6 / 120 + 60e6 / 127 + 60e6 / 131 = 1430456.2 us
+    CHECK(intervals[0] == 500000 && intervals[0] + intervals[1] + intervals[2] == 1430456,
+          "intervals %u %u %u", intervals[0], intervals[1], intervals[2]);
+
+    // Rewinding plays the curve again from the first step
+    tempo_automation_rewind(&automation);
+    CHECK(tempo_automation_next_interval(&automation) == 500000, "first interval after rewind");
+}
+
+/**
+ * Check the argument and table size errors
+ *
+ * @return void.
+ */
+static void test_errors(void)
+{
+    tempo_automation_t automation;
+    tempo_automation_init(&automation);
+    CHECK(tempo_automation_add_hold(&automation, 0, 4) == ESP_ERR_INVALID_ARG, "hold at 0 bpm");
+    CHECK(tempo_automation_add_hold(&automation, 80, 0) == ESP_ERR_INVALID_ARG, "hold of 0 beats");
+    CHECK(tempo_automation_add_ramp(&automation, 80, 1000, 4) == ESP_ERR_INVALID_ARG, "ramp to 1000 bpm");
+    CHECK(tempo_automation_add_steps(&automation, 120, 2, 4, 100) == ESP_ERR_INVALID_ARG, "steps below the start");
+    CHECK(tempo_automation_add_steps(&automation, 80, 0, 4, 100) == ESP_ERR_INVALID_ARG, "steps of 0 bpm");
+    for (int i = 0; i < TEMPO_AUTOMATION_MAX_SEGMENTS; i++)
+    {
+        tempo_automation_add_hold(&automation, 80, 1);
+    }
+    CHECK(tempo_automation_add_hold(&automation, 80, 1) == ESP_ERR_NO_MEM, "hold added to a full table");
+    tempo_automation_init(&automation);
+    for (int i = 0; i < TEMPO_AUTOMATION_MAX_SEGMENTS / TEMPO_AUTOMATION_RAMP_PIECES; i++)
+    {
+        tempo_automation_add_ramp(&automation, 80, 120, 128);
+    }
+    CHECK(tempo_automation_add_ramp(&automation, 80, 120, 128) == ESP_ERR_NO_MEM, "ramp added to a full table");
+
+    // The step intervals of all step segments share one table
+    tempo_automation_init(&automation);
+    CHECK(tempo_automation_add_steps(&automation, 60, 1, 4, 60 + TEMPO_AUTOMATION_MAX_STEPS) == ESP_ERR_NO_MEM, "too many steps added");
+    CHECK(tempo_automation_add_steps(&automation, 60, 1, 4, 59 + TEMPO_AUTOMATION_MAX_STEPS / 2) == ESP_OK &&
+              tempo_automation_add_steps(&automation, 60, 1, 4, 59 + TEMPO_AUTOMATION_MAX_STEPS / 2) == ESP_OK,
+          "steps filling the table refused");
+    CHECK(tempo_automation_add_steps(&automation, 60, 1, 4, 60) == ESP_ERR_NO_MEM, "step added to a full table");
+}
+
+/**
+ * Measure the cost of one beat
+ *
+ * @return void.
+ */
+static void benchmark(void)
+{
+    tempo_automation_t automation;
+    tempo_automation_init(&automation);
+    tempo_automation_add_ramp(&automation, 80, 120, BENCHMARK_BEATS);
+    clock_t start = clock();
+    uint64_t time = 0;
+    while (!tempo_automation_done(&automation))
+    {
+        time += tempo_automation_next_interval(&automation);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%.2f ns per beat over %d beats, %llu us played\n", seconds * 1e9 / BENCHMARK_BEATS, BENCHMARK_BEATS,
+           (unsigned long long)time);
+}
+
+int main(void)
+{
+    test_hold_exact();
+    test_ramp_integral();
+    test_steps();
+    test_errors();
+    benchmark();
+    printf("%s\n", test_failures ? "FAILED" : "passed");
+    return test_failures != 0;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Generate the compressed SSD1306 glyph store from the bitmaps in resources.c.
+
+The bitmaps are rows of 32 pixels, 4 bytes per row with the leftmost pixel in the most significant bit.
+The panel memory is pages of 8 rows, one byte per column with the top row in the least significant bit.
+Each glyph is converted to GLYPH_PAGES pages of GLYPH_COLUMNS columns, the same result the ssd1306
+component gives when a bitmap is drawn with ssd1306_bitmaps and read back with ssd1306_get_buffer.
+The images are run length encoded back to back with an index of offsets, see glyph_store.h for the format.
+
+Usage: glyph_gen.py <resources.c> <glyph_store_data.c>
+"""
+
+import re
+import sys
+
+GLYPH_PAGES = 4
+GLYPH_COLUMNS = 32
+BYTES_PER_ROW = GLYPH_COLUMNS // 8
+MAX_LITERALS = 128 # Control bytes 0x00-0x7F are followed by 1-128 literal bytes
+MIN_RUN = 2        # Control bytes 0x80-0xFF repeat the next byte 2-129 times
+MAX_RUN = 129
+
+# Bitmap arrays to convert and the image count macro of each
+ARRAYS = [
+    ("signatures", "SIGNATURE_IMAGES"),
+    ("numbers", "NUMBER_IMAGES"),
+    ("standby", "STANDBY_IMAGES"),
+]
+
+
+def parse_bitmaps(source):
+    """Return the bitmaps of every segment_display_* array as lists of byte lists."""
+    source = re.sub(r"//[^\n]*", "", source)
+    arrays = {}
+    for match in re.finditer(r"segment_display_(\w+)\s*\[\w+\]\s*\[\d+\]\s*=\s*\{(.*?)\};", source, re.S):
+        bitmaps = re.findall(r"\{([^{}]*)\}", match.group(2))
+        arrays[match.group(1)] = [[int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]+", bitmap)] for bitmap in bitmaps]
+    return arrays
+
+
+def convert(bitmap):
+    """Convert one row ordered bitmap to page ordered image bytes."""
+    bitmap = bitmap + [0] * (GLYPH_PAGES * 8 * BYTES_PER_ROW - len(bitmap))
+    image = []
+    for page in range(GLYPH_PAGES):
+        for column in range(GLYPH_COLUMNS):
+            value = 0
+            for bit in range(8):
+                row = page * 8 + bit
+                if bitmap[row * BYTES_PER_ROW + column // 8] & (0x80 >> (column % 8)):
+                    value |= 1 << bit
+            image.append(value)
+    return image
+
+
+def encode(image):
+    """Run length encode one image."""
+    encoded = []
+    index = 0
+    while index < len(image):
+        run = 1
+        while index + run < len(image) and image[index + run] == image[index] and run < MAX_RUN:
+            run += 1
+        if run >= MIN_RUN:
+            encoded += [0x80 + run - MIN_RUN, image[index]]
+            index += run
+            continue
+
+        # Collect literals until the next run starts
+        start = index
+        index += 1
+        while index < len(image) and index - start < MAX_LITERALS and not (
+                index + 1 < len(image) and image[index] == image[index + 1]):
+            index += 1
+        encoded += [index - start - 1] + image[start:index]
+    return encoded
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    with open(sys.argv[1]) as source_file:
+        arrays = parse_bitmaps(source_file.read())
+
+    # Every image of every array in order, the glyph ids of glyph_store.h follow the same order
+    data = []
+    offsets = [0]
+    for name, count in ARRAYS:
+        if name not in arrays:
+            sys.exit("glyph_gen.py: segment_display_%s not found" % name)
+        for bitmap in arrays[name]:
+            data += encode(convert(bitmap))
+            offsets.append(len(data))
+
+    lines = ["// Generated by tools/glyph_gen.py from resources.c, do not edit", '#include "glyph_store.h"', ""]
+    lines.append('_Static_assert(GLYPH_COUNT == %d, "Glyph ids do not match resources.c");' % (len(offsets) - 1))
+    lines.append("")
+    lines.append("const uint16_t glyph_store_index[GLYPH_COUNT + 1] = {%s};" % ", ".join(str(offset) for offset in offsets))
+    lines.append("")
+    lines.append("const uint8_t glyph_store_data[%d] = {" % len(data))
+    for row in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % value for value in data[row:row + 16]) + ",")
+    lines.append("};")
+    lines.append("")
+
+    with open(sys.argv[2], "w") as output_file:
+        output_file.write("\n".join(lines))
+
+
+if __name__ == "__main__":
+    main()
\ No newline at end of file